@@ -0,0 +1,432 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+template <typename T, typename Alloc = std::allocator<T>>
+class CompactList {
+ private:
+  using Index = uint32_t;
+
+  struct Slot {
+    Index prev;
+    Index next;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() { return reinterpret_cast<T*>(storage); }
+  };
+
+  static constexpr Index fakeNode = 0;
+  static constexpr Index no_slot = std::numeric_limits<Index>::max();
+
+  using SlotAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+  SlotAlloc slot_alloc_;
+  Slot* slots_ = nullptr;
+  Index capacity_ = 0;
+  Index used_ = 0;
+  Index free_ = no_slot;
+  size_t size_ = 0;
+
+  void move_into(Slot* new_slots, Index new_capacity, bool in_order) {
+    Index count = 1;
+    new_slots[fakeNode].prev = fakeNode;
+    new_slots[fakeNode].next = fakeNode;
+    try {
+      if (in_order) {
+        for (Index i = slots_[fakeNode].next; i != fakeNode;
+             i = slots_[i].next, ++count) {
+          new (new_slots[count].value())
+              T(std::move_if_noexcept(*slots_[i].value()));
+          new_slots[count].prev = count - 1;
+          new_slots[count - 1].next = count;
+        }
+        new_slots[count - 1].next = fakeNode;
+        new_slots[fakeNode].prev = count - 1;
+      } else {
+        for (Index i = slots_[fakeNode].next; i != fakeNode;
+             i = slots_[i].next, ++count) {
+          new (new_slots[i].value())
+              T(std::move_if_noexcept(*slots_[i].value()));
+        }
+        for (Index i = 0; i < used_; ++i) {
+          new_slots[i].prev = slots_[i].prev;
+          new_slots[i].next = slots_[i].next;
+        }
+      }
+    } catch (...) {
+      Index constructed = 1;
+      for (Index i = slots_[fakeNode].next; constructed < count;
+           i = slots_[i].next, ++constructed) {
+        (in_order ? new_slots[constructed] : new_slots[i]).value()->~T();
+      }
+      std::allocator_traits<SlotAlloc>::deallocate(slot_alloc_, new_slots,
+                                                   new_capacity);
+      throw;
+    }
+    release_slots();
+    slots_ = new_slots;
+    capacity_ = new_capacity;
+    if (in_order) {
+      used_ = count;
+      free_ = no_slot;
+    }
+  }
+
+  void release_slots() {
+    if (slots_ == nullptr) {
+      return;
+    }
+    for (Index i = slots_[fakeNode].next; i != fakeNode; i = slots_[i].next) {
+      slots_[i].value()->~T();
+    }
+    std::allocator_traits<SlotAlloc>::deallocate(slot_alloc_, slots_,
+                                                 capacity_);
+    slots_ = nullptr;
+  }
+
+  Index acquire_slot() {
+    if (free_ != no_slot) {
+      Index slot = free_;
+      free_ = slots_[slot].next;
+      return slot;
+    }
+    if (used_ == capacity_) {
+      if (capacity_ == no_slot) {
+        throw std::length_error("CompactList is full");
+      }
+      Index new_capacity =
+          capacity_ > no_slot / 2 ? no_slot : std::max<Index>(2 * capacity_, 8);
+      reserve_slots(new_capacity);
+    }
+    return used_++;
+  }
+
+  void reserve_slots(Index new_capacity) {
+    Slot* new_slots =
+        std::allocator_traits<SlotAlloc>::allocate(slot_alloc_, new_capacity);
+    if (slots_ == nullptr) {
+      slots_ = new_slots;
+      capacity_ = new_capacity;
+      slots_[fakeNode].prev = fakeNode;
+      slots_[fakeNode].next = fakeNode;
+      used_ = 1;
+      return;
+    }
+    move_into(new_slots, new_capacity, false);
+  }
+
+  void release_slot(Index slot) {
+    slots_[slot].next = free_;
+    free_ = slot;
+  }
+
+  void link_before(Index pos, Index slot) {
+    Index prev_slot = slots_[pos].prev;
+    slots_[prev_slot].next = slot;
+    slots_[slot].prev = prev_slot;
+    slots_[pos].prev = slot;
+    slots_[slot].next = pos;
+    ++size_;
+  }
+
+  void unlink(Index slot) {
+    Index prev_slot = slots_[slot].prev;
+    Index next_slot = slots_[slot].next;
+    slots_[prev_slot].next = next_slot;
+    slots_[next_slot].prev = prev_slot;
+    --size_;
+  }
+
+  void destroy_slots() {
+    release_slots();
+    capacity_ = 0;
+    used_ = 0;
+    free_ = no_slot;
+    size_ = 0;
+  }
+
+  void take_slots(CompactList& other) {
+    slots_ = std::exchange(other.slots_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+    used_ = std::exchange(other.used_, 0);
+    free_ = std::exchange(other.free_, no_slot);
+    size_ = std::exchange(other.size_, 0);
+  }
+
+  void ensure_sentinel() {
+    if (slots_ == nullptr) {
+      reserve_slots(8);
+    }
+  }
+
+ public:
+  CompactList() = default;
+
+  CompactList(Alloc allocator) : slot_alloc_(allocator) {}
+
+  CompactList(size_t count, const T& value, Alloc allocator = Alloc())
+      : slot_alloc_(allocator) {
+    try {
+      for (size_t i = 0; i < count; ++i) {
+        push_back(value);
+      }
+    } catch (...) {
+      release_slots();
+      throw;
+    }
+  }
+
+  CompactList(const CompactList& other)
+      : slot_alloc_(std::allocator_traits<SlotAlloc>::
+                        select_on_container_copy_construction(
+                            other.slot_alloc_)) {
+    try {
+      for (const T& value : other) {
+        push_back(value);
+      }
+    } catch (...) {
+      release_slots();
+      throw;
+    }
+  }
+
+  CompactList(CompactList&& other) noexcept
+      : slot_alloc_(other.slot_alloc_),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        used_(std::exchange(other.used_, 0)),
+        free_(std::exchange(other.free_, no_slot)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  CompactList& operator=(const CompactList& other) {
+    if (&other == this) {
+      return *this;
+    }
+    destroy_slots();
+    if constexpr (std::allocator_traits<
+                      SlotAlloc>::propagate_on_container_copy_assignment::value) {
+      slot_alloc_ = other.slot_alloc_;
+    }
+    for (const T& value : other) {
+      push_back(value);
+    }
+    return *this;
+  }
+
+  CompactList& operator=(CompactList&& other) noexcept(
+      std::allocator_traits<SlotAlloc>::propagate_on_container_move_assignment::value ||
+      std::allocator_traits<SlotAlloc>::is_always_equal::value) {
+    if (&other == this) {
+      return *this;
+    }
+    destroy_slots();
+    if constexpr (std::allocator_traits<
+                      SlotAlloc>::propagate_on_container_move_assignment::value) {
+      slot_alloc_ = other.slot_alloc_;
+      take_slots(other);
+    } else {
+      if (slot_alloc_ == other.slot_alloc_) {
+        take_slots(other);
+      } else {
+        for (T& value : other) {
+          emplace_back(std::move(value));
+        }
+      }
+    }
+    return *this;
+  }
+
+  ~CompactList() { release_slots(); }
+
+  void swap(CompactList& other) noexcept {
+    if constexpr (std::allocator_traits<
+                      SlotAlloc>::propagate_on_container_swap::value) {
+      std::swap(slot_alloc_, other.slot_alloc_);
+    }
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(used_, other.used_);
+    std::swap(free_, other.free_);
+    std::swap(size_, other.size_);
+  }
+
+  size_t size() const { return size_; }
+
+  SlotAlloc get_allocator() const { return slot_alloc_; }
+
+  void reserve(size_t count) {
+    if (count + 1 > no_slot) {
+      throw std::length_error("CompactList is full");
+    }
+    if (count + 1 > capacity_) {
+      reserve_slots(static_cast<Index>(count + 1));
+    }
+  }
+
+  void compact() {
+    if (slots_ == nullptr) {
+      return;
+    }
+    Index new_capacity = static_cast<Index>(size_ + 1);
+    Slot* new_slots =
+        std::allocator_traits<SlotAlloc>::allocate(slot_alloc_, new_capacity);
+    move_into(new_slots, new_capacity, true);
+  }
+
+  template <bool is_const>
+  struct Compact_Iterator {
+    using Container =
+        std::conditional_t<is_const, const CompactList, CompactList>;
+    Container* list;
+    Index slot;
+
+    Compact_Iterator() : list(nullptr), slot(fakeNode) {}
+    Compact_Iterator(Container* list1, Index slot1) : list(list1), slot(slot1) {}
+
+    Compact_Iterator& operator++() {
+      slot = list->slots_[slot].next;
+      return *this;
+    }
+
+    Compact_Iterator operator++(int) {
+      Compact_Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    Compact_Iterator& operator--() {
+      slot = list->slots_[slot].prev;
+      return *this;
+    }
+
+    Compact_Iterator operator--(int) {
+      Compact_Iterator copy = *this;
+      --*this;
+      return copy;
+    }
+
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<is_const, const T*, T*>;
+    using reference = std::conditional_t<is_const, const T&, T&>;
+
+    reference operator*() const { return *list->slots_[slot].value(); }
+
+    pointer operator->() const { return list->slots_[slot].value(); }
+
+    operator Compact_Iterator<true>() const {
+      return Compact_Iterator<true>(list, slot);
+    }
+
+    bool operator==(const Compact_Iterator& another) const = default;
+    bool operator!=(const Compact_Iterator& another) const = default;
+  };
+
+  using iterator = Compact_Iterator<false>;
+  using const_iterator = Compact_Iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  iterator begin() {
+    return {this, slots_ == nullptr ? fakeNode : slots_[fakeNode].next};
+  }
+
+  const_iterator begin() const {
+    return {this, slots_ == nullptr ? fakeNode : slots_[fakeNode].next};
+  }
+
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return {this, fakeNode}; }
+
+  const_iterator end() const { return {this, fakeNode}; }
+
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  template <bool is_const, typename... Args>
+  iterator emplace(Compact_Iterator<is_const> it, Args&&... args) {
+    ensure_sentinel();
+    Index pos = it.slot;
+    Index slot;
+    if (free_ == no_slot && used_ == capacity_) {
+      T value(std::forward<Args>(args)...);
+      slot = acquire_slot();
+      try {
+        new (slots_[slot].value()) T(std::move(value));
+      } catch (...) {
+        release_slot(slot);
+        throw;
+      }
+    } else {
+      slot = acquire_slot();
+      try {
+        new (slots_[slot].value()) T(std::forward<Args>(args)...);
+      } catch (...) {
+        release_slot(slot);
+        throw;
+      }
+    }
+    link_before(pos, slot);
+    return {this, slot};
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    emplace(end(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    emplace(begin(), std::forward<Args>(args)...);
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void push_front(const T& value) { emplace_front(value); }
+
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  template <bool is_const>
+  iterator insert(Compact_Iterator<is_const> it, const T& value) {
+    return emplace(it, value);
+  }
+
+  template <bool is_const>
+  iterator insert(Compact_Iterator<is_const> it, T&& value) {
+    return emplace(it, std::move(value));
+  }
+
+  template <bool is_const>
+  iterator erase(Compact_Iterator<is_const> it) {
+    Index slot = it.slot;
+    Index next_slot = slots_[slot].next;
+    unlink(slot);
+    slots_[slot].value()->~T();
+    release_slot(slot);
+    return {this, next_slot};
+  }
+
+  void pop_back() { erase(--end()); }
+
+  void pop_front() { erase(begin()); }
+};
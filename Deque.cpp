@@ -1,31 +1,60 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <deque>
 
 template <typename T>
+constexpr size_t deque_block_size() {
+  return sizeof(T) < 256 ? std::bit_floor(512 / sizeof(T)) : 1;
+}
+
+template <typename T, size_t BlockSize = deque_block_size<T>(),
+          typename Alloc = std::allocator<T>>
 class Deque;
 
-template <typename T, bool is_const>
+template <typename T, bool is_const, size_t BlockSize = deque_block_size<T>()>
 class Deque_iterator {
  public:
   T** array;
-  int pos;
-  size_t sz_of_arrays;
-  Deque_iterator(T** array, int pos, size_t sz) : array(array), pos(pos), sz_of_arrays(sz) {}
-  Deque_iterator() : array(nullptr), pos(0), sz_of_arrays(32) {}
+  T* cur;
+  T* first;
+  T* last;
+
+  Deque_iterator(T** array, T* cur)
+      : array(array), cur(cur), first(*array), last(*array + BlockSize) {}
+  Deque_iterator()
+      : array(nullptr), cur(nullptr), first(nullptr), last(nullptr) {}
+
+  void set_block(T** new_array) {
+    array = new_array;
+    first = *new_array;
+    last = first + BlockSize;
+  }
 
  public:
   using iterator_category = std::random_access_iterator_tag;
   using value_type = std::conditional_t<is_const, const T, T>;
-  using difference_type = int;
+  using difference_type = std::ptrdiff_t;
   using pointer = std::conditional_t<is_const, const T*, T*>;
   using reference = std::conditional_t<is_const, const T&, T&>;
 
+  static constexpr difference_type block_size = BlockSize;
 
   Deque_iterator& operator++() {
-    if (++pos == static_cast<int>(sz_of_arrays)) {
-      array++;
-      pos = 0;
+    if (++cur == last) {
+      set_block(array + 1);
+      cur = first;
     }
     return *this;
   }
@@ -37,420 +66,928 @@ class Deque_iterator {
   }
 
   Deque_iterator& operator--() {
-    if (--pos == -1) {
-      array--;
-      pos = sz_of_arrays - 1;
+    if (cur == first) {
+      set_block(array - 1);
+      cur = last;
     }
+    --cur;
     return *this;
   }
 
-  Deque_iterator& operator+=(int shift) {
-    int array_shift = (pos + shift) / sz_of_arrays;
-    T** new_arr = array + array_shift;
-    int new_pos = (pos + shift) % sz_of_arrays;
-    Deque_iterator a(new_arr, new_pos, sz_of_arrays);
-    *this = a;
+  Deque_iterator operator--(int) {
+    Deque_iterator copy = *this;
+    --*this;
+    return copy;
+  }
+
+  Deque_iterator& operator+=(difference_type shift) {
+    difference_type offset = shift + (cur - first);
+    if (offset >= 0 && offset < block_size) {
+      cur += shift;
+      return *this;
+    }
+    difference_type array_shift;
+    if constexpr (std::has_single_bit(BlockSize)) {
+      array_shift = offset >> std::countr_zero(BlockSize);
+      offset &= block_size - 1;
+    } else {
+      array_shift = offset >= 0 ? offset / block_size
+                                : -((-offset - 1) / block_size) - 1;
+      offset -= array_shift * block_size;
+    }
+    set_block(array + array_shift);
+    cur = first + offset;
     return *this;
   }
 
-  Deque_iterator operator+(int shift) const {
+  Deque_iterator operator+(difference_type shift) const {
     Deque_iterator a = *this;
     a += shift;
     return a;
   }
 
-  Deque_iterator operator-=(int shift) {
-    int array_shift = (sz_of_arrays + (shift - pos) - 1) / sz_of_arrays;
-    T** new_arr = array - array_shift;
-    int new_pos = (pos - shift) % sz_of_arrays;
-    new_pos = (new_pos + sz_of_arrays ) % sz_of_arrays;
-    Deque_iterator a(new_arr, new_pos, sz_of_arrays);
-    *this = a;
-    return *this;
+  Deque_iterator& operator-=(difference_type shift) {
+    return *this += -shift;
   }
 
-  Deque_iterator operator-(int shift) const {
+  Deque_iterator operator-(difference_type shift) const {
     Deque_iterator a = *this;
     a -= shift;
     return a;
   }
 
+  reference operator[](difference_type shift) const { return *(*this + shift); }
 
-//  friend bool operator<(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b);
-//  friend bool operator==(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b);
-//  friend int operator-(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b);
-//  friend class Deque<T>;
+  reference operator*() const { return *cur; }
 
-  using type1 = std::conditional_t<is_const, const T&, T&>;
-  using type2 = std::conditional_t<is_const, const T*, T*>;
+  pointer operator->() const { return cur; }
 
-  type1 operator*() {
-    return *(*array + pos);
-  }
-
-  const type1 operator*() const {
-    return *(*array + pos);
-  }
-
-  type2 operator->() {
-    return *array + pos;
-  }
-
-  operator Deque_iterator<T, true>() {
-    return (Deque_iterator<T, true>(array, pos, sz_of_arrays));
+  operator Deque_iterator<T, true, BlockSize>() const {
+    Deque_iterator<T, true, BlockSize> it;
+    it.array = array;
+    it.cur = cur;
+    it.first = first;
+    it.last = last;
+    return it;
   }
-
 };
 
-template <typename T, bool is_const>
-bool operator<(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
+template <typename T, bool is_const, size_t BlockSize>
+bool operator<(const Deque_iterator<T, is_const, BlockSize>& a,
+               const Deque_iterator<T, is_const, BlockSize>& b) {
   if (a.array == b.array) {
-    return a.pos < b.pos;
+    return a.cur < b.cur;
   } else {
     return a.array < b.array;
   }
 }
 
-template <typename T, bool is_const>
-bool operator==(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
-  return (a.array == b.array && a.pos == b.pos);
+template <typename T, bool is_const, size_t BlockSize>
+bool operator==(const Deque_iterator<T, is_const, BlockSize>& a,
+                const Deque_iterator<T, is_const, BlockSize>& b) {
+  return a.cur == b.cur;
 }
 
-template <typename T, bool is_const>
-bool operator>(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
+template <typename T, bool is_const, size_t BlockSize>
+bool operator>(const Deque_iterator<T, is_const, BlockSize>& a,
+               const Deque_iterator<T, is_const, BlockSize>& b) {
   return b < a;
 }
 
-template <typename T, bool is_const>
-bool operator>=(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
-  return !(b > a);
+template <typename T, bool is_const, size_t BlockSize>
+bool operator>=(const Deque_iterator<T, is_const, BlockSize>& a,
+                const Deque_iterator<T, is_const, BlockSize>& b) {
+  return !(a < b);
 }
 
-template <typename T, bool is_const>
-bool operator<=(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
+template <typename T, bool is_const, size_t BlockSize>
+bool operator<=(const Deque_iterator<T, is_const, BlockSize>& a,
+                const Deque_iterator<T, is_const, BlockSize>& b) {
   return !(b < a);
 }
 
-template <typename T, bool is_const>
-bool operator!=(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
+template <typename T, bool is_const, size_t BlockSize>
+bool operator!=(const Deque_iterator<T, is_const, BlockSize>& a,
+                const Deque_iterator<T, is_const, BlockSize>& b) {
   return !(a == b);
 }
 
-template <typename T, bool is_const>
-int operator-(const Deque_iterator<T, is_const>& a, const Deque_iterator<T, is_const>& b) {
+template <typename T, bool is_const, size_t BlockSize>
+std::ptrdiff_t operator-(const Deque_iterator<T, is_const, BlockSize>& a,
+                         const Deque_iterator<T, is_const, BlockSize>& b) {
   if (a.array == b.array) {
-    return a.pos - b.pos;
+    return a.cur - b.cur;
   }
-  int s1 = b.sz_of_arrays - b.pos - 1;
-  int s2 = ((a.array - b.array) - 1) * a.sz_of_arrays;
-  int s3 = a.pos + 1;
-  return s1 + s2 + s3;
+  return static_cast<std::ptrdiff_t>(BlockSize) * (a.array - b.array - 1) +
+         (a.cur - a.first) + (b.last - b.cur);
 }
 
-template <typename T>
+template <typename T, bool is_const, size_t BlockSize>
+Deque_iterator<T, is_const, BlockSize> operator+(
+    std::ptrdiff_t shift, const Deque_iterator<T, is_const, BlockSize>& it) {
+  return it + shift;
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
 class Deque {
  public:
-  std::vector<T*> source;
-  size_t size_of_arrays = 32;
-  Deque_iterator<T, false> front_of_start;
-  Deque_iterator<T, false> after_last;
+  using BlockAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+  using MapAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<T*>;
+  using BlockTraits = std::allocator_traits<BlockAlloc>;
 
-  using iterator = Deque_iterator<T, false>;
-  using const_iterator = Deque_iterator<T, true>;
+  BlockAlloc block_alloc_;
+  std::vector<T*, MapAlloc> source;
+  std::vector<T*, MapAlloc> spare_blocks;
+  size_t max_spare_blocks = 2;
+  Deque_iterator<T, false, BlockSize> start;
+  Deque_iterator<T, false, BlockSize> finish;
 
-  void ReallocateAndPush(bool at_the_end, const T& value) {
-    size_t sz = source.size();
-    int count_of_elements = size();
-    std::vector<T*> new_arr(sz * 3);
+  using iterator = Deque_iterator<T, false, BlockSize>;
+  using const_iterator = Deque_iterator<T, true, BlockSize>;
 
-    for (size_t i = 0; i < sz; ++i) {
-      new_arr[i] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
+  T* allocate_block() {
+    return BlockTraits::allocate(block_alloc_, BlockSize);
+  }
+
+  void deallocate_block(T* block) {
+    BlockTraits::deallocate(block_alloc_, block, BlockSize);
+  }
+
+  template <typename... Args>
+  void construct_element(T* place, Args&&... args) {
+    BlockTraits::construct(block_alloc_, place, std::forward<Args>(args)...);
+  }
+
+  void destroy_element(T* place) {
+    BlockTraits::destroy(block_alloc_, place);
+  }
+
+  T* acquire_block() {
+    if (spare_blocks.empty()) {
+      return allocate_block();
+    }
+    T* block = spare_blocks.back();
+    spare_blocks.pop_back();
+    return block;
+  }
+
+  void recycle_block(T* block) {
+    if (spare_blocks.size() < max_spare_blocks) {
+      try {
+        spare_blocks.push_back(block);
+        return;
+      } catch (...) {
+      }
     }
-    for (size_t i = sz; i < 2 * sz; ++i) {
-      new_arr[i] = source[i - sz];
+    deallocate_block(block);
+  }
+
+  void release_spare_blocks() {
+    for (T* block : spare_blocks) {
+      deallocate_block(block);
+    }
+    spare_blocks.clear();
+  }
+
+  void ReallocateMap(size_t blocks_to_add, bool at_front) {
+    size_t old_blocks = finish.array - start.array + 1;
+    size_t new_blocks = old_blocks + blocks_to_add;
+    T** new_start;
+    if (source.size() > 2 * new_blocks) {
+      new_start = source.data() + (source.size() - new_blocks) / 2 +
+                  (at_front ? blocks_to_add : 0);
+      if (new_start < start.array) {
+        std::copy(start.array, finish.array + 1, new_start);
+      } else {
+        std::copy_backward(start.array, finish.array + 1,
+                           new_start + old_blocks);
+      }
+      std::fill(source.data(), new_start, nullptr);
+      std::fill(new_start + old_blocks, source.data() + source.size(),
+                nullptr);
+    } else {
+      size_t new_size =
+          source.size() + std::max(source.size(), blocks_to_add) + 2;
+      std::vector<T*, MapAlloc> new_source(new_size, nullptr,
+                                           source.get_allocator());
+      new_start = new_source.data() + (new_size - new_blocks) / 2 +
+                  (at_front ? blocks_to_add : 0);
+      std::copy(start.array, finish.array + 1, new_start);
+      source.swap(new_source);
     }
-    for (size_t i = 2 * sz; i < 3 * sz; ++i) {
-      new_arr[i] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
+    start.array = new_start;
+    finish.array = new_start + old_blocks - 1;
+  }
+
+  template <typename... Args>
+  void ReallocateAndPush(bool at_the_end, Args&&... args) {
+    if (source.empty()) {
+      initialize_map(0);
+      start.cur = at_the_end ? start.last - 1 : start.first;
+      finish = start;
+    }
+    if (at_the_end) {
+      if (finish.array + 1 == source.data() + source.size()) {
+        ReallocateMap(1, false);
+      }
+      *(finish.array + 1) = acquire_block();
+      try {
+        construct_element(finish.cur, std::forward<Args>(args)...);
+      } catch (...) {
+        recycle_block(*(finish.array + 1));
+        *(finish.array + 1) = nullptr;
+        throw;
+      }
+      finish.set_block(finish.array + 1);
+      finish.cur = finish.first;
+    } else {
+      if (start.array == source.data()) {
+        ReallocateMap(1, true);
+      }
+      *(start.array - 1) = acquire_block();
+      T* new_cur = *(start.array - 1) + (BlockSize - 1);
+      try {
+        construct_element(new_cur, std::forward<Args>(args)...);
+      } catch (...) {
+        recycle_block(*(start.array - 1));
+        *(start.array - 1) = nullptr;
+        throw;
+      }
+      start.set_block(start.array - 1);
+      start.cur = new_cur;
     }
-    int arr_of_begin = front_of_start.array - &source[0];
-    Deque_iterator<T, false> new_start(&new_arr[sz + arr_of_begin],
-                                       front_of_start.pos, size_of_arrays);
-    Deque_iterator<T, false> new_finish = new_start + count_of_elements + 1;
+  }
 
+  void initialize_map(size_t count) {
+    size_t blocks = count / BlockSize + 1;
+    source.assign(blocks + 2, nullptr);
+    T** first_block = source.data() + 1;
+    size_t allocated = 0;
     try {
-      if (at_the_end) {
-        new ((*new_finish.array) + new_finish.pos) T(value);
-        ++new_finish;
-      } else {
-        new ((*new_start.array) + new_start.pos) T(value);
-        --new_start;
+      for (; allocated < blocks; ++allocated) {
+        first_block[allocated] = allocate_block();
       }
     } catch (...) {
-      for (Deque_iterator<T, false> it = new_start + 1; it < new_finish; ++it) {
-        (*it.array + it.pos)->~T();
-      }
-      for (size_t k = 0; k < 3 * sz; ++k) {
-        delete[] reinterpret_cast<char*>(new_arr[k]);
+      for (size_t k = 0; k < allocated; ++k) {
+        deallocate_block(first_block[k]);
       }
+      source.clear();
       throw;
     }
+    start = iterator(first_block, *first_block);
+    finish = start;
+  }
 
-    source = new_arr;
-    Deque_iterator<T, false> new_star(&new_arr[sz + arr_of_begin],
-                                      front_of_start.pos, size_of_arrays);
+  void destroy_range(iterator first, iterator last) {
+    if constexpr (!std::is_trivially_destructible_v<T> ||
+                  requires(BlockAlloc& alloc, T* place) {
+                    alloc.destroy(place);
+                  }) {
+      for (; first != last; ++first) {
+        destroy_element(first.cur);
+      }
+    }
+  }
 
-    front_of_start = Deque_iterator<T, false>(&source[sz + arr_of_begin],
-                                              front_of_start.pos, size_of_arrays);
-    if (!at_the_end) {
-      --front_of_start;
+  static iterator move_range(iterator first, iterator last, iterator dest) {
+    std::ptrdiff_t count = last - first;
+    while (count > 0) {
+      std::ptrdiff_t chunk =
+          std::min({count, first.last - first.cur, dest.last - dest.cur});
+      std::move(first.cur, first.cur + chunk, dest.cur);
+      first += chunk;
+      dest += chunk;
+      count -= chunk;
     }
+    return dest;
+  }
+
+  static iterator move_range_backward(iterator first, iterator last,
+                                      iterator dest) {
+    std::ptrdiff_t count = last - first;
+    while (count > 0) {
+      T* last_end = last.cur == last.first ? *(last.array - 1) + BlockSize
+                                           : last.cur;
+      T* dest_end = dest.cur == dest.first ? *(dest.array - 1) + BlockSize
+                                           : dest.cur;
+      std::ptrdiff_t last_room =
+          last.cur == last.first ? BlockSize : last.cur - last.first;
+      std::ptrdiff_t dest_room =
+          dest.cur == dest.first ? BlockSize : dest.cur - dest.first;
+      std::ptrdiff_t chunk = std::min({count, last_room, dest_room});
+      std::move_backward(last_end - chunk, last_end, dest_end);
+      last -= chunk;
+      dest -= chunk;
+      count -= chunk;
+    }
+    return dest;
+  }
 
-    after_last = front_of_start + count_of_elements + 2;
+  iterator reserve_elements_at_front(size_t count) {
+    size_t vacancies = start.cur - start.first;
+    if (count > vacancies) {
+      size_t new_blocks = (count - vacancies + BlockSize - 1) / BlockSize;
+      if (new_blocks > static_cast<size_t>(start.array - source.data())) {
+        ReallocateMap(new_blocks, true);
+      }
+      size_t allocated = 1;
+      try {
+        for (; allocated <= new_blocks; ++allocated) {
+          *(start.array - allocated) = acquire_block();
+        }
+      } catch (...) {
+        recycle_blocks(start.array - allocated + 1, start.array);
+        throw;
+      }
+    }
+    return start - count;
   }
 
- public:
+  iterator reserve_elements_at_back(size_t count) {
+    size_t vacancies = finish.last - finish.cur - 1;
+    if (count > vacancies) {
+      size_t new_blocks = (count - vacancies + BlockSize - 1) / BlockSize;
+      if (new_blocks > static_cast<size_t>(source.data() + source.size() -
+                                           finish.array - 1)) {
+        ReallocateMap(new_blocks, false);
+      }
+      size_t allocated = 1;
+      try {
+        for (; allocated <= new_blocks; ++allocated) {
+          *(finish.array + allocated) = acquire_block();
+        }
+      } catch (...) {
+        recycle_blocks(finish.array + 1, finish.array + allocated);
+        throw;
+      }
+    }
+    return finish + count;
+  }
 
-  Deque() {
-    source = std::vector<T*>(1);
-    source[0] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
-    front_of_start = Deque_iterator<T, false>(&source[0], 0, size_of_arrays);
-    after_last = Deque_iterator<T, false>(&source[0], 1, size_of_arrays);
+  void recycle_blocks(T** first, T** last) {
+    for (; first < last; ++first) {
+      recycle_block(*first);
+      *first = nullptr;
+    }
   }
 
-  Deque(Deque const &src) : size_of_arrays(src.size_of_arrays) {
-    source = std::vector<T*>(src.size());
-    for (size_t i = 0; i < src.size(); ++i) {
-      source[i] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
+  template <typename ForwardIt>
+  iterator insert_n(size_t index, size_t count, ForwardIt src) {
+    if (count == 0) {
+      return start + index;
     }
-    int arr_of_begin = src.front_of_start.array - &src.source[0];
-    int arr_of_end = src.after_last.array - &src.source[0];
-    front_of_start = Deque_iterator<T, false>(&source[arr_of_begin],
-                                              src.front_of_start.pos, size_of_arrays);
-    after_last = Deque_iterator<T, false>(&source[arr_of_end],
-                                          src.after_last.pos, size_of_arrays);
-    auto it1 = src.begin();
-    for (auto it0 = begin(); it0 < end(); ++it0) {
-      new (*it0.array + it0.pos) T(*it1);
-      ++it1;
+    if (source.empty()) {
+      initialize_map(0);
+    }
+    size_t elems = size();
+    if (index < elems / 2) {
+      iterator new_start = reserve_elements_at_front(count);
+      iterator old_start = start;
+      iterator pos = start + index;
+      iterator constructed = new_start;
+      try {
+        if (index >= count) {
+          for (iterator it = old_start; constructed != old_start;
+               ++it, ++constructed) {
+            construct_element(constructed.cur, std::move(*it));
+          }
+          start = new_start;
+          move_range(old_start + count, pos, old_start);
+          for (iterator it = pos - count; it != pos; ++it, ++src) {
+            *it = *src;
+          }
+        } else {
+          for (iterator it = old_start; it != pos; ++it, ++constructed) {
+            construct_element(constructed.cur, std::move(*it));
+          }
+          for (; constructed != old_start; ++constructed, ++src) {
+            construct_element(constructed.cur, *src);
+          }
+          start = new_start;
+          for (iterator it = old_start; it != pos; ++it, ++src) {
+            *it = *src;
+          }
+        }
+      } catch (...) {
+        if (start != new_start) {
+          destroy_range(new_start, constructed);
+          recycle_blocks(new_start.array, start.array);
+        }
+        throw;
+      }
+    } else {
+      size_t elems_after = elems - index;
+      iterator new_finish = reserve_elements_at_back(count);
+      iterator old_finish = finish;
+      iterator pos = start + index;
+      iterator constructed = old_finish;
+      try {
+        if (elems_after > count) {
+          for (iterator it = old_finish - count; constructed != new_finish;
+               ++it, ++constructed) {
+            construct_element(constructed.cur, std::move(*it));
+          }
+          finish = new_finish;
+          move_range_backward(pos, old_finish - count, old_finish);
+          for (size_t k = 0; k < count; ++k, ++pos, ++src) {
+            *pos = *src;
+          }
+        } else {
+          ForwardIt mid = src;
+          for (size_t k = 0; k < elems_after; ++k) {
+            ++mid;
+          }
+          for (size_t k = elems_after; k < count; ++k, ++constructed, ++mid) {
+            construct_element(constructed.cur, *mid);
+          }
+          for (iterator it = pos; it != old_finish; ++it, ++constructed) {
+            construct_element(constructed.cur, std::move(*it));
+          }
+          finish = new_finish;
+          for (iterator it = pos; it != old_finish; ++it, ++src) {
+            *it = *src;
+          }
+        }
+      } catch (...) {
+        if (finish != new_finish) {
+          destroy_range(old_finish, constructed);
+          recycle_blocks(finish.array + 1, new_finish.array + 1);
+        }
+        throw;
+      }
     }
+    return start + index;
+  }
+
+  void release_storage() {
+    destroy_range(start, finish);
+    release_blocks();
+    release_spare_blocks();
+    source.clear();
+    start = iterator();
+    finish = iterator();
   }
 
-  Deque(const int size) {
-    int count_of_arrays = (size + size_of_arrays + 1) / size_of_arrays;
-    source = std::vector<T*>(count_of_arrays);
-    for (int i = 0 ; i < count_of_arrays; ++i) {
-      source[i] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
+  void take_storage(Deque& other) {
+    size_t start_index = other.start.array - other.source.data();
+    size_t finish_index = other.finish.array - other.source.data();
+    if (source.get_allocator() == other.source.get_allocator()) {
+      source.swap(other.source);
+      spare_blocks.swap(other.spare_blocks);
+    } else {
+      source = std::vector<T*, MapAlloc>(other.source.begin(),
+                                         other.source.end(),
+                                         MapAlloc(block_alloc_));
+      spare_blocks = std::vector<T*, MapAlloc>(other.spare_blocks.begin(),
+                                               other.spare_blocks.end(),
+                                               MapAlloc(block_alloc_));
+    }
+    max_spare_blocks = other.max_spare_blocks;
+    start = std::exchange(other.start, iterator());
+    finish = std::exchange(other.finish, iterator());
+    if (!source.empty()) {
+      start.array = source.data() + start_index;
+      finish.array = source.data() + finish_index;
     }
-    Deque_iterator<T, false> new_start(&source[0],
-                                       0, size_of_arrays);
-    Deque_iterator<T, false> new_finish = new_start + 1;
+    other.source.clear();
+    other.spare_blocks.clear();
+  }
 
-    try {
-      for (int i = 1; i <= size; ++i) {
-        new (*new_finish.array + new_finish.pos) T();
-        ++new_finish;
-      }
-    } catch (...) {
-      for (Deque_iterator<T, false> it = new_start + 1; it < new_finish; ++it) {
-        (*it.array + it.pos)->~T();
-      }
-      for (size_t k = 0; k < count_of_arrays; ++k) {
-        delete[] reinterpret_cast<char*>(source[k]);
+  void release_blocks() {
+    for (T* block : source) {
+      if (block != nullptr) {
+        deallocate_block(block);
       }
-      throw;
     }
-
-    after_last = new_finish;
-    front_of_start = new_start;
   }
 
-  Deque(int size, const T& el) {
-    int count_of_arrays = (size + size_of_arrays + 1) / size_of_arrays;
-    source = std::vector<T*>(count_of_arrays);
-    for (int i = 0 ; i < count_of_arrays; ++i) {
-      source[i] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
+ public:
+
+  Deque() : Deque(Alloc()) {}
+
+  Deque(Alloc allocator)
+      : block_alloc_(allocator),
+        source(MapAlloc(block_alloc_)),
+        spare_blocks(MapAlloc(block_alloc_)) {}
+
+  Deque(const Deque& src, Alloc allocator) : Deque(allocator) {
+    max_spare_blocks = src.max_spare_blocks;
+    initialize_map(src.size());
+    for (auto it = src.begin(); it != src.end(); ++it) {
+      construct_element(finish.cur, *it);
+      ++finish;
     }
+  }
+
+  Deque(const Deque& src)
+      : Deque(src, BlockTraits::select_on_container_copy_construction(
+                       src.block_alloc_)) {}
 
+  Deque(const int size, Alloc allocator = Alloc()) : Deque(allocator) {
+    initialize_map(size);
     for (int i = 1; i <= size; ++i) {
-      new (source[i / size_of_arrays] + (i % size_of_arrays)) T(el);
+      construct_element(finish.cur);
+      ++finish;
     }
+  }
 
-    front_of_start = Deque_iterator<T, false>(&source[0],
-                                              0, size_of_arrays);
+  Deque(int size, const T& el, Alloc allocator = Alloc()) : Deque(allocator) {
+    initialize_map(size);
+    for (int i = 1; i <= size; ++i) {
+      construct_element(finish.cur, el);
+      ++finish;
+    }
+  }
 
-    after_last = Deque_iterator<T, false>(&source[count_of_arrays - 1],
-                                          (size + 1) % size_of_arrays, size_of_arrays);
+  Deque(Deque&& src) noexcept
+      : block_alloc_(src.block_alloc_),
+        source(MapAlloc(block_alloc_)),
+        spare_blocks(MapAlloc(block_alloc_)),
+        max_spare_blocks(src.max_spare_blocks),
+        start(std::exchange(src.start, iterator())),
+        finish(std::exchange(src.finish, iterator())) {
+    source.swap(src.source);
+    spare_blocks.swap(src.spare_blocks);
   }
 
   Deque& operator=(const Deque& src) {
-    size_of_arrays = src.size_of_arrays;
-    source = std::vector<T*>(src.source.size());
-    for (size_t i = 0; i < src.source.size(); ++i) {
-      source[i] = reinterpret_cast<T*>(new char[size_of_arrays * sizeof(T)]);
-    }
-    int arr_of_begin = src.front_of_start.array - &src.source[0];
-    int arr_of_end = src.after_last.array - &src.source[0];
-    front_of_start = Deque_iterator<T, false>(&source[arr_of_begin],
-                                              src.front_of_start.pos, size_of_arrays);
-    after_last = Deque_iterator<T, false>(&source[arr_of_end],
-                                          src.after_last.pos, size_of_arrays);
-    auto it1 = src.begin();
-    for (auto it0 = begin(); it0 < end(); ++it0) {
-      new (*it0.array + it0.pos) T(*it1);
-      ++it1;
+    if (&src == this) {
+      return *this;
+    }
+    if constexpr (BlockTraits::propagate_on_container_copy_assignment::value) {
+      Deque tmp(src, src.block_alloc_);
+      release_storage();
+      block_alloc_ = src.block_alloc_;
+      take_storage(tmp);
+    } else {
+      Deque tmp(src, block_alloc_);
+      release_storage();
+      take_storage(tmp);
     }
     return *this;
   }
 
+  Deque& operator=(Deque&& src) noexcept(
+      BlockTraits::propagate_on_container_move_assignment::value ||
+      BlockTraits::is_always_equal::value) {
+    if (&src == this) {
+      return *this;
+    }
+    if constexpr (BlockTraits::propagate_on_container_move_assignment::value) {
+      release_storage();
+      block_alloc_ = src.block_alloc_;
+      take_storage(src);
+    } else {
+      if (block_alloc_ == src.block_alloc_) {
+        release_storage();
+        take_storage(src);
+      } else {
+        Deque tmp(block_alloc_);
+        tmp.insert(tmp.end(), std::make_move_iterator(src.begin()),
+                   std::make_move_iterator(src.end()));
+        release_storage();
+        take_storage(tmp);
+      }
+    }
+    return *this;
+  }
+
+  void swap(Deque& other) noexcept {
+    if constexpr (BlockTraits::propagate_on_container_swap::value) {
+      std::swap(block_alloc_, other.block_alloc_);
+    }
+    source.swap(other.source);
+    spare_blocks.swap(other.spare_blocks);
+    std::swap(max_spare_blocks, other.max_spare_blocks);
+    std::swap(start, other.start);
+    std::swap(finish, other.finish);
+  }
+
   size_t size() const {
-    return (after_last - front_of_start) - 1;
+    return finish - start;
+  }
+
+  BlockAlloc get_allocator() const {
+    return block_alloc_;
   }
 
-  T& operator[](int pos) {
-    return *(front_of_start + (1 + pos));
+  void set_max_spare_blocks(size_t count) {
+    max_spare_blocks = count;
+    while (spare_blocks.size() > max_spare_blocks) {
+      deallocate_block(spare_blocks.back());
+      spare_blocks.pop_back();
+    }
+    spare_blocks.reserve(max_spare_blocks);
   }
 
-  const T& operator[](int pos) const {
-    return *(front_of_start + (1 + pos));
+  void shrink_to_fit() {
+    release_spare_blocks();
+    spare_blocks.shrink_to_fit();
+  }
+
+  T& operator[](size_t pos) {
+    return *(start + pos);
+  }
+
+  const T& operator[](size_t pos) const {
+    return *(start + pos);
   }
 
   T& at(size_t pos) {
     if (pos >= size()) {
       throw std::out_of_range("out of range");
     }
-    return *(front_of_start + (1 + pos));
+    return *(start + pos);
   }
 
   const T& at(size_t pos) const {
     if (pos >= size()) {
       throw std::out_of_range("out of range");
     }
-    return *(front_of_start + (1 + pos));
+    return *(start + pos);
   }
 
-  void push_back(const T& value) {
-    if (static_cast<unsigned long>(after_last.array - &source[0]) > source.size() - 1) {
-      try {
-        ReallocateAndPush(true, value);
-      } catch(...) {
-        throw;
-      }
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    if (finish.last - finish.cur > 1) {
+      construct_element(finish.cur, std::forward<Args>(args)...);
+      ++finish.cur;
     } else {
-      new (*after_last.array + after_last.pos) T(value);
-      ++after_last;
+      ReallocateAndPush(true, std::forward<Args>(args)...);
     }
   }
 
-  void push_front(const T& value) {
-    if ((front_of_start.array == &source[0] && front_of_start.pos == 0) ) {
-      try {
-        ReallocateAndPush(false, value);
-      } catch(...) {
-        throw;
-      }
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    if (start.cur != start.first) {
+      construct_element(start.cur - 1, std::forward<Args>(args)...);
+      --start.cur;
     } else {
-      new (*front_of_start.array + front_of_start.pos) T(value);
-      --front_of_start;
+      ReallocateAndPush(false, std::forward<Args>(args)...);
     }
   }
 
+  void push_back(const T& value) {
+    emplace_back(value);
+  }
+
+  void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  void push_front(const T& value) {
+    emplace_front(value);
+  }
+
+  void push_front(T&& value) {
+    emplace_front(std::move(value));
+  }
+
   void pop_back() {
-    --after_last;
-    (*after_last.array + after_last.pos)->~T();
+    if (finish.cur == finish.first) {
+      recycle_block(*finish.array);
+      *finish.array = nullptr;
+      finish.set_block(finish.array - 1);
+      finish.cur = finish.last;
+    }
+    --finish.cur;
+    destroy_element(finish.cur);
   }
 
   void pop_front() {
-    ++front_of_start;
-    (*front_of_start.array + front_of_start.pos)->~T();
+    destroy_element(start.cur);
+    if (start.cur == start.last - 1) {
+      recycle_block(*start.array);
+      *start.array = nullptr;
+      start.set_block(start.array + 1);
+      start.cur = start.first;
+    } else {
+      ++start.cur;
+    }
   }
 
-  Deque_iterator<T, false> begin() {
-    return {(front_of_start + 1).array, (front_of_start + 1).pos, size_of_arrays};
+  iterator begin() {
+    return start;
   }
 
-  Deque_iterator<T, true> begin() const {
-    return {(front_of_start + 1).array, (front_of_start + 1).pos, size_of_arrays};
+  const_iterator begin() const {
+    return start;
   }
 
-  Deque_iterator<T, true> cbegin() {
-    return {(front_of_start + 1).array, (front_of_start + 1).pos, size_of_arrays};
+  const_iterator cbegin() const {
+    return start;
   }
 
-  Deque_iterator<T, false> end() {
-    return after_last;
+  iterator end() {
+    return finish;
   }
 
-  Deque_iterator<T, true> end() const {
-    return {(after_last).array, (after_last).pos, size_of_arrays};
+  const_iterator end() const {
+    return finish;
   }
 
-  Deque_iterator<T, true> cend() {
-    return { after_last.array, after_last.pos, size_of_arrays };
+  const_iterator cend() const {
+    return finish;
   }
 
-
   std::reverse_iterator<iterator> rbegin() {
-    std::reverse_iterator it (end());
-    return it;
+    return std::reverse_iterator(end());
   }
 
   std::reverse_iterator<const_iterator> rbegin() const {
-    std::reverse_iterator it (cend());
-    return it;
+    return std::reverse_iterator(cend());
   }
 
-  std::reverse_iterator<Deque_iterator<T, true>> crbegin() const {
-    std::reverse_iterator it (cend());
-    return it;
+  std::reverse_iterator<const_iterator> crbegin() const {
+    return std::reverse_iterator(cend());
   }
 
   std::reverse_iterator<iterator> rend() {
-    std::reverse_iterator it ((iterator(front_of_start) + 1));
-    return it;
+    return std::reverse_iterator(begin());
   }
 
+  std::reverse_iterator<const_iterator> rend() const {
+    return std::reverse_iterator(cbegin());
+  }
 
-  std::reverse_iterator<Deque_iterator<T, true>> rend() const {
-    std::reverse_iterator it ((const_iterator(front_of_start)) + 1);
-    return it;
+  std::reverse_iterator<const_iterator> crend() const {
+    return std::reverse_iterator(cbegin());
   }
 
-  std::reverse_iterator<Deque_iterator<T, true>> crend() {
-    std::reverse_iterator it ((const_iterator(front_of_start)) + 1);
-    return it;
+  template <typename... Args>
+  iterator emplace(iterator it, Args&&... args) {
+    T value(std::forward<Args>(args)...);
+    return insert_n(it - start, 1, std::make_move_iterator(&value));
+  }
+
+  iterator insert(iterator it, const T& value) {
+    T copy(value);
+    return insert_n(it - start, 1, std::make_move_iterator(&copy));
   }
 
-  void insert(Deque_iterator<T, false> it, const T& value) {
-    if (it == end()) {
-      push_back(value);
+  iterator insert(iterator it, T&& value) {
+    T moved(std::move(value));
+    return insert_n(it - start, 1, std::make_move_iterator(&moved));
+  }
+
+  iterator insert(iterator it, size_t count, const T& value) {
+    T copy(value);
+    auto repeated = std::views::iota(size_t(0), count) |
+                    std::views::transform(
+                        [&copy](size_t) -> const T& { return copy; });
+    return insert_n(it - start, count, repeated.begin());
+  }
+
+  template <typename InputIt>
+    requires std::input_iterator<InputIt>
+  iterator insert(iterator it, InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) {
+      return insert_n(it - start, std::distance(first, last), first);
     } else {
-      T replaced1_value = *(it);
-      T replaced2_value = *(it);
-      *it = value;
-      ++it;
-      for (; it < end(); ++it) {
-        replaced1_value = *it;
-        *it = replaced2_value;
-        replaced2_value = replaced1_value;
-      }
-      push_back(replaced2_value);
+      std::vector<T> buffer(first, last);
+      return insert_n(it - start, buffer.size(),
+                      std::make_move_iterator(buffer.begin()));
     }
   }
 
-  void erase(Deque_iterator<T, false> it) {
-    for (; it < end() - 1; ++it) {
-      *(it) = *(it + 1);
+  iterator erase(iterator first, iterator last) {
+    size_t index = first - start;
+    size_t count = last - first;
+    if (count == 0) {
+      return first;
+    }
+    if (index < (size() - count) / 2) {
+      move_range_backward(start, first, last);
+      iterator new_start = start + count;
+      destroy_range(start, new_start);
+      recycle_blocks(start.array, new_start.array);
+      start = new_start;
+    } else {
+      move_range(last, finish, first);
+      iterator new_finish = finish - count;
+      destroy_range(new_finish, finish);
+      recycle_blocks(new_finish.array + 1, finish.array + 1);
+      finish = new_finish;
     }
-    pop_back();
+    return start + index;
+  }
+
+  iterator erase(iterator it) {
+    return erase(it, it + 1);
   }
 
   ~Deque() {
-    for (Deque_iterator<T, false> it = begin() + 1; it < end(); ++it) {
-      (*it.array + it.pos)->~T();
+    destroy_range(start, finish);
+    release_blocks();
+    release_spare_blocks();
+  }
+
+};
+
+template <typename T, bool is_const, size_t BlockSize, typename Func>
+void for_each_segment(Deque_iterator<T, is_const, BlockSize> first,
+                      Deque_iterator<T, is_const, BlockSize> last, Func func) {
+  using value_type = std::conditional_t<is_const, const T, T>;
+  while (true) {
+    T* segment_end = first.array == last.array ? last.cur : first.last;
+    if (first.cur != segment_end) {
+      func(std::span<value_type>(first.cur, segment_end));
     }
-    for (size_t k = 0; k < source.size(); ++k) {
-      delete[] reinterpret_cast<char*>(source[k]);
+    if (first.array == last.array) {
+      return;
     }
+    first.set_block(first.array + 1);
+    first.cur = first.first;
   }
+}
 
-};
+template <typename T, size_t BlockSize, typename Alloc, typename Func>
+void for_each_segment(Deque<T, BlockSize, Alloc>& deque, Func func) {
+  for_each_segment(deque.begin(), deque.end(), func);
+}
+
+template <typename T, size_t BlockSize, typename Alloc, typename Func>
+void for_each_segment(const Deque<T, BlockSize, Alloc>& deque, Func func) {
+  for_each_segment(deque.begin(), deque.end(), func);
+}
+
+namespace segmented {
+
+template <typename T, bool is_const, size_t BlockSize, typename Func>
+Func for_each(Deque_iterator<T, is_const, BlockSize> first,
+              Deque_iterator<T, is_const, BlockSize> last, Func func) {
+  for_each_segment(first, last, [&func](auto segment) {
+    for (auto& value : segment) {
+      func(value);
+    }
+  });
+  return func;
+}
+
+template <typename T, size_t BlockSize>
+void fill(Deque_iterator<T, false, BlockSize> first,
+          Deque_iterator<T, false, BlockSize> last, const T& value) {
+  for_each_segment(first, last, [&value](std::span<T> segment) {
+    std::fill(segment.begin(), segment.end(), value);
+  });
+}
+
+template <typename T, bool is_const, size_t BlockSize, typename OutputIt>
+OutputIt copy(Deque_iterator<T, is_const, BlockSize> first,
+              Deque_iterator<T, is_const, BlockSize> last, OutputIt out) {
+  for_each_segment(first, last, [&out](auto segment) {
+    out = std::copy(segment.begin(), segment.end(), out);
+  });
+  return out;
+}
+
+template <typename T, bool is_const, size_t BlockSize, typename U>
+Deque_iterator<T, is_const, BlockSize> find(
+    Deque_iterator<T, is_const, BlockSize> first,
+    Deque_iterator<T, is_const, BlockSize> last, const U& value) {
+  while (true) {
+    T* segment_end = first.array == last.array ? last.cur : first.last;
+    T* found = std::find(first.cur, segment_end, value);
+    if (found != segment_end) {
+      first.cur = found;
+      return first;
+    }
+    if (first.array == last.array) {
+      return last;
+    }
+    first.set_block(first.array + 1);
+    first.cur = first.first;
+  }
+}
+
+template <typename T, bool is_const, size_t BlockSize, typename U>
+std::ptrdiff_t count(Deque_iterator<T, is_const, BlockSize> first,
+                     Deque_iterator<T, is_const, BlockSize> last,
+                     const U& value) {
+  std::ptrdiff_t result = 0;
+  for_each_segment(first, last, [&result, &value](auto segment) {
+    result += std::count(segment.begin(), segment.end(), value);
+  });
+  return result;
+}
+
+template <typename T, bool is_const, size_t BlockSize, typename Acc,
+          typename BinaryOp>
+Acc accumulate(Deque_iterator<T, is_const, BlockSize> first,
+               Deque_iterator<T, is_const, BlockSize> last, Acc init,
+               BinaryOp op) {
+  for_each_segment(first, last, [&init, &op](auto segment) {
+    init = std::accumulate(segment.begin(), segment.end(), std::move(init), op);
+  });
+  return init;
+}
+
+template <typename T, bool is_const, size_t BlockSize, typename Acc>
+Acc accumulate(Deque_iterator<T, is_const, BlockSize> first,
+               Deque_iterator<T, is_const, BlockSize> last, Acc init) {
+  return segmented::accumulate(first, last, std::move(init), std::plus<>());
+}
+
+}  // namespace segmented
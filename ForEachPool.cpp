@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ForEachPool {
+ private:
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::function<void()>> tasks;
+  std::vector<std::thread> workers;
+  bool stopping;
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      std::function<void()> task = std::move(tasks.front());
+      tasks.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+ public:
+  explicit ForEachPool(size_t threads_count) : stopping(false) {
+    workers.reserve(threads_count);
+    for (size_t i = 0; i < threads_count; ++i) {
+      workers.emplace_back([this] { work(); });
+    }
+  }
+
+  ForEachPool(const ForEachPool& src) = delete;
+
+  static ForEachPool& shared() {
+    static ForEachPool pool(
+        std::max<size_t>(1, std::thread::hardware_concurrency()) - 1);
+    return pool;
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+  }
+
+  bool run_pending() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (tasks.empty()) {
+      return false;
+    }
+    std::function<void()> task = std::move(tasks.front());
+    tasks.pop_front();
+    lock.unlock();
+    task();
+    return true;
+  }
+
+  ForEachPool& operator=(const ForEachPool& src) = delete;
+
+  ~ForEachPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+};
@@ -0,0 +1,447 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+template <typename T, typename Alloc = std::allocator<T>>
+class IndexedList {
+ private:
+  struct BaseNode {
+    BaseNode* prev;
+    BaseNode* next;
+
+    BaseNode() {
+      prev = &(*this);
+      next = &(*this);
+    }
+  };
+
+  struct TreeNode : BaseNode {
+    TreeNode* left = nullptr;
+    TreeNode* right = nullptr;
+    TreeNode* parent = nullptr;
+    size_t count = 1;
+    uint32_t priority = 0;
+  };
+
+  struct Node : TreeNode {
+    T value;
+
+    template <typename... Args>
+    Node(Args&&... args) : TreeNode(), value(std::forward<Args>(args)...) {}
+  };
+
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  size_t size_ = 0;
+  NodeAlloc node_alloc_;
+  BaseNode fakeNode;
+  TreeNode* root_ = nullptr;
+  uint32_t seed_ = 2463534242u;
+
+  static size_t count_of(TreeNode* node) {
+    return node == nullptr ? 0 : node->count;
+  }
+
+  static void update(TreeNode* node) {
+    node->count = 1 + count_of(node->left) + count_of(node->right);
+  }
+
+  uint32_t next_priority() {
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    return seed_;
+  }
+
+  void replace_child(TreeNode* parent, TreeNode* old_child,
+                     TreeNode* new_child) {
+    if (parent == nullptr) {
+      root_ = new_child;
+    } else if (parent->left == old_child) {
+      parent->left = new_child;
+    } else {
+      parent->right = new_child;
+    }
+    if (new_child != nullptr) {
+      new_child->parent = parent;
+    }
+  }
+
+  void rotate_up(TreeNode* node) {
+    TreeNode* parent = node->parent;
+    TreeNode* grandparent = parent->parent;
+    if (parent->left == node) {
+      parent->left = node->right;
+      if (node->right != nullptr) {
+        node->right->parent = parent;
+      }
+      node->right = parent;
+    } else {
+      parent->right = node->left;
+      if (node->left != nullptr) {
+        node->left->parent = parent;
+      }
+      node->left = parent;
+    }
+    parent->parent = node;
+    replace_child(grandparent, parent, node);
+    update(parent);
+    update(node);
+  }
+
+  void tree_insert_before(BaseNode* pos, TreeNode* node) {
+    node->priority = next_priority();
+    if (root_ == nullptr) {
+      root_ = node;
+      return;
+    }
+    TreeNode* parent;
+    if (pos == &fakeNode) {
+      parent = static_cast<TreeNode*>(fakeNode.prev);
+      parent->right = node;
+    } else if (static_cast<TreeNode*>(pos)->left == nullptr) {
+      parent = static_cast<TreeNode*>(pos);
+      parent->left = node;
+    } else {
+      parent = static_cast<TreeNode*>(pos->prev);
+      parent->right = node;
+    }
+    node->parent = parent;
+    for (TreeNode* ancestor = parent; ancestor != nullptr;
+         ancestor = ancestor->parent) {
+      ++ancestor->count;
+    }
+    while (node->parent != nullptr && node->parent->priority > node->priority) {
+      rotate_up(node);
+    }
+  }
+
+  void tree_erase(TreeNode* node) {
+    while (node->left != nullptr && node->right != nullptr) {
+      rotate_up(node->left->priority < node->right->priority ? node->left
+                                                              : node->right);
+    }
+    TreeNode* child = node->left != nullptr ? node->left : node->right;
+    TreeNode* parent = node->parent;
+    replace_child(parent, node, child);
+    for (TreeNode* ancestor = parent; ancestor != nullptr;
+         ancestor = ancestor->parent) {
+      --ancestor->count;
+    }
+  }
+
+  template <typename... Args>
+  Node* link_new_node(BaseNode* pos, Args&&... args) {
+    Node* new_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
+    try {
+      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node,
+                                                  std::forward<Args>(args)...);
+    } catch (...) {
+      std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, new_node, 1);
+      throw;
+    }
+    tree_insert_before(pos, new_node);
+    BaseNode* prev_node = pos->prev;
+    prev_node->next = new_node;
+    new_node->prev = prev_node;
+    pos->prev = new_node;
+    new_node->next = pos;
+    ++size_;
+    return new_node;
+  }
+
+  void destroy_nodes() {
+    BaseNode* node = fakeNode.next;
+    while (node != &fakeNode) {
+      BaseNode* next_node = node->next;
+      std::allocator_traits<NodeAlloc>::destroy(node_alloc_,
+                                                static_cast<Node*>(node));
+      std::allocator_traits<NodeAlloc>::deallocate(node_alloc_,
+                                                   static_cast<Node*>(node), 1);
+      node = next_node;
+    }
+    fakeNode.next = &fakeNode;
+    fakeNode.prev = &fakeNode;
+    root_ = nullptr;
+    size_ = 0;
+  }
+
+  void take_nodes(IndexedList& other) {
+    if (other.size_ != 0) {
+      fakeNode.next = other.fakeNode.next;
+      fakeNode.prev = other.fakeNode.prev;
+      fakeNode.next->prev = &fakeNode;
+      fakeNode.prev->next = &fakeNode;
+    }
+    root_ = std::exchange(other.root_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    other.fakeNode.next = &other.fakeNode;
+    other.fakeNode.prev = &other.fakeNode;
+  }
+
+ public:
+  IndexedList() : fakeNode() {}
+
+  IndexedList(Alloc allocator) : node_alloc_(allocator), fakeNode() {}
+
+  IndexedList(size_t count, const T& value, Alloc allocator = Alloc())
+      : node_alloc_(allocator), fakeNode() {
+    try {
+      for (size_t i = 0; i < count; ++i) {
+        push_back(value);
+      }
+    } catch (...) {
+      destroy_nodes();
+      throw;
+    }
+  }
+
+  IndexedList(const IndexedList& other)
+      : node_alloc_(std::allocator_traits<NodeAlloc>::
+                        select_on_container_copy_construction(
+                            other.node_alloc_)),
+        fakeNode() {
+    try {
+      for (const BaseNode* node = other.fakeNode.next; node != &other.fakeNode;
+           node = node->next) {
+        push_back(static_cast<const Node*>(node)->value);
+      }
+    } catch (...) {
+      destroy_nodes();
+      throw;
+    }
+  }
+
+  IndexedList(IndexedList&& other) noexcept
+      : node_alloc_(other.node_alloc_), fakeNode() {
+    take_nodes(other);
+  }
+
+  IndexedList& operator=(const IndexedList& other) {
+    if (&other == this) {
+      return *this;
+    }
+    destroy_nodes();
+    if constexpr (std::allocator_traits<
+                      NodeAlloc>::propagate_on_container_copy_assignment::value) {
+      node_alloc_ = other.node_alloc_;
+    }
+    for (const BaseNode* node = other.fakeNode.next; node != &other.fakeNode;
+         node = node->next) {
+      push_back(static_cast<const Node*>(node)->value);
+    }
+    return *this;
+  }
+
+  IndexedList& operator=(IndexedList&& other) noexcept(
+      std::allocator_traits<NodeAlloc>::propagate_on_container_move_assignment::value ||
+      std::allocator_traits<NodeAlloc>::is_always_equal::value) {
+    if (&other == this) {
+      return *this;
+    }
+    destroy_nodes();
+    if constexpr (std::allocator_traits<
+                      NodeAlloc>::propagate_on_container_move_assignment::value) {
+      node_alloc_ = other.node_alloc_;
+      take_nodes(other);
+    } else {
+      if (node_alloc_ == other.node_alloc_) {
+        take_nodes(other);
+      } else {
+        for (BaseNode* node = other.fakeNode.next; node != &other.fakeNode;
+             node = node->next) {
+          emplace_back(std::move(static_cast<Node*>(node)->value));
+        }
+      }
+    }
+    return *this;
+  }
+
+  ~IndexedList() { destroy_nodes(); }
+
+  size_t size() const { return size_; }
+
+  NodeAlloc get_allocator() const { return node_alloc_; }
+
+  void clear() { destroy_nodes(); }
+
+  template <bool is_const>
+  struct Indexed_Iterator {
+    BaseNode* node;
+
+    Indexed_Iterator() : node(nullptr) {}
+    Indexed_Iterator(const BaseNode* node1)
+        : node(const_cast<BaseNode*>(node1)) {}
+
+    Indexed_Iterator& operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    Indexed_Iterator operator++(int) {
+      Indexed_Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    Indexed_Iterator& operator--() {
+      node = node->prev;
+      return *this;
+    }
+
+    Indexed_Iterator operator--(int) {
+      Indexed_Iterator copy = *this;
+      --*this;
+      return copy;
+    }
+
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<is_const, const T*, T*>;
+    using reference = std::conditional_t<is_const, const T&, T&>;
+
+    reference operator*() const { return static_cast<Node*>(node)->value; }
+
+    pointer operator->() const { return &static_cast<Node*>(node)->value; }
+
+    operator Indexed_Iterator<true>() const {
+      return Indexed_Iterator<true>(node);
+    }
+
+    bool operator==(const Indexed_Iterator& another) const = default;
+    bool operator!=(const Indexed_Iterator& another) const = default;
+  };
+
+  using iterator = Indexed_Iterator<false>;
+  using const_iterator = Indexed_Iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  iterator begin() { return {fakeNode.next}; }
+
+  const_iterator begin() const { return {fakeNode.next}; }
+
+  const_iterator cbegin() const { return {fakeNode.next}; }
+
+  iterator end() { return {&fakeNode}; }
+
+  const_iterator end() const { return {&fakeNode}; }
+
+  const_iterator cend() const { return {&fakeNode}; }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  template <bool is_const, typename... Args>
+  iterator emplace(Indexed_Iterator<is_const> it, Args&&... args) {
+    return {link_new_node(it.node, std::forward<Args>(args)...)};
+  }
+
+  template <bool is_const>
+  iterator insert(Indexed_Iterator<is_const> it, const T& value) {
+    return emplace(it, value);
+  }
+
+  template <bool is_const>
+  iterator insert(Indexed_Iterator<is_const> it, T&& value) {
+    return emplace(it, std::move(value));
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    link_new_node(&fakeNode, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    link_new_node(fakeNode.next, std::forward<Args>(args)...);
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void push_front(const T& value) { emplace_front(value); }
+
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  template <bool is_const>
+  iterator erase(Indexed_Iterator<is_const> it) {
+    BaseNode* node = it.node;
+    BaseNode* prev_node = node->prev;
+    BaseNode* next_node = node->next;
+    tree_erase(static_cast<TreeNode*>(node));
+    prev_node->next = next_node;
+    next_node->prev = prev_node;
+    --size_;
+    std::allocator_traits<NodeAlloc>::destroy(node_alloc_,
+                                              static_cast<Node*>(node));
+    std::allocator_traits<NodeAlloc>::deallocate(node_alloc_,
+                                                 static_cast<Node*>(node), 1);
+    return {next_node};
+  }
+
+  void pop_back() { erase(--end()); }
+
+  void pop_front() { erase(begin()); }
+
+  iterator nth(size_t index) {
+    if (index >= size_) {
+      return end();
+    }
+    TreeNode* node = root_;
+    while (true) {
+      size_t left_count = count_of(node->left);
+      if (index < left_count) {
+        node = node->left;
+      } else if (index == left_count) {
+        return {node};
+      } else {
+        index -= left_count + 1;
+        node = node->right;
+      }
+    }
+  }
+
+  const_iterator nth(size_t index) const {
+    return const_cast<IndexedList*>(this)->nth(index);
+  }
+
+  template <bool is_const>
+  size_t index_of(Indexed_Iterator<is_const> it) const {
+    if (it.node == &fakeNode) {
+      return size_;
+    }
+    TreeNode* node = static_cast<TreeNode*>(it.node);
+    size_t index = count_of(node->left);
+    for (; node->parent != nullptr; node = node->parent) {
+      if (node->parent->right == node) {
+        index += count_of(node->parent->left) + 1;
+      }
+    }
+    return index;
+  }
+
+  template <bool is_const>
+  Indexed_Iterator<is_const> advance(Indexed_Iterator<is_const> it,
+                                     std::ptrdiff_t shift) {
+    return nth(index_of(it) + shift);
+  }
+
+  T& operator[](size_t index) { return *nth(index); }
+
+  const T& operator[](size_t index) const { return *nth(index); }
+};
@@ -0,0 +1,208 @@
+#include <bit>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+template <bool AutoUnlink = false>
+struct IntrusiveListHook {
+  IntrusiveListHook* prev = nullptr;
+  IntrusiveListHook* next = nullptr;
+
+  IntrusiveListHook() = default;
+
+  IntrusiveListHook(const IntrusiveListHook&) {}
+
+  IntrusiveListHook& operator=(const IntrusiveListHook&) { return *this; }
+
+  bool is_linked() const { return next != nullptr; }
+
+  void unlink() {
+    prev->next = next;
+    next->prev = prev;
+    prev = nullptr;
+    next = nullptr;
+  }
+
+  ~IntrusiveListHook() {
+    if constexpr (AutoUnlink) {
+      if (is_linked()) {
+        unlink();
+      }
+    }
+  }
+};
+
+template <typename Member>
+struct IntrusiveMemberTraits;
+
+template <typename T, bool AutoUnlink>
+struct IntrusiveMemberTraits<IntrusiveListHook<AutoUnlink> T::*> {
+  using value_type = T;
+  using hook_type = IntrusiveListHook<AutoUnlink>;
+  static constexpr bool auto_unlink = AutoUnlink;
+};
+
+template <typename T, auto Hook>
+class IntrusiveList {
+ private:
+  using Traits = IntrusiveMemberTraits<decltype(Hook)>;
+  using BaseNode = typename Traits::hook_type;
+  static_assert(std::is_same_v<typename Traits::value_type, T>);
+  static_assert(std::is_standard_layout_v<T>);
+  static_assert(sizeof(Hook) == sizeof(std::ptrdiff_t));
+
+  static constexpr bool constant_size = !Traits::auto_unlink;
+
+  size_t size_ = 0;
+  BaseNode fakeNode;
+
+  static BaseNode* hook_of(T& value) { return &(value.*Hook); }
+
+  static std::ptrdiff_t hook_offset() {
+    return std::bit_cast<std::ptrdiff_t>(Hook);
+  }
+
+  static T* owner_of(BaseNode* node) {
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(node) - hook_offset());
+  }
+
+  void link_before(BaseNode* pos, BaseNode* node) {
+    BaseNode* prev_node = pos->prev;
+    prev_node->next = node;
+    node->prev = prev_node;
+    pos->prev = node;
+    node->next = pos;
+    if constexpr (constant_size) {
+      ++size_;
+    }
+  }
+
+  void unlink_node(BaseNode* node) {
+    node->unlink();
+    if constexpr (constant_size) {
+      --size_;
+    }
+  }
+
+ public:
+  IntrusiveList() {
+    fakeNode.prev = &fakeNode;
+    fakeNode.next = &fakeNode;
+  }
+
+  IntrusiveList(const IntrusiveList& src) = delete;
+  IntrusiveList& operator=(const IntrusiveList& src) = delete;
+
+  ~IntrusiveList() { clear(); }
+
+  template <bool is_const>
+  struct Intrusive_Iterator {
+    BaseNode* node;
+
+    Intrusive_Iterator() : node(nullptr) {}
+    Intrusive_Iterator(const BaseNode* node1)
+        : node(const_cast<BaseNode*>(node1)) {}
+
+    Intrusive_Iterator& operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    Intrusive_Iterator operator++(int) {
+      Intrusive_Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    Intrusive_Iterator& operator--() {
+      node = node->prev;
+      return *this;
+    }
+
+    Intrusive_Iterator operator--(int) {
+      Intrusive_Iterator copy = *this;
+      --*this;
+      return copy;
+    }
+
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<is_const, const T*, T*>;
+    using reference = std::conditional_t<is_const, const T&, T&>;
+
+    reference operator*() const { return *owner_of(node); }
+
+    pointer operator->() const { return owner_of(node); }
+
+    operator Intrusive_Iterator<true>() const {
+      return Intrusive_Iterator<true>(node);
+    }
+
+    bool operator==(const Intrusive_Iterator& another) const = default;
+    bool operator!=(const Intrusive_Iterator& another) const = default;
+  };
+
+  using iterator = Intrusive_Iterator<false>;
+  using const_iterator = Intrusive_Iterator<true>;
+
+  iterator begin() { return {fakeNode.next}; }
+
+  const_iterator begin() const { return {fakeNode.next}; }
+
+  iterator end() { return {&fakeNode}; }
+
+  const_iterator end() const { return {&fakeNode}; }
+
+  static iterator iterator_to(T& value) { return {hook_of(value)}; }
+
+  bool empty() const { return fakeNode.next == &fakeNode; }
+
+  size_t size() const {
+    if constexpr (constant_size) {
+      return size_;
+    } else {
+      size_t count = 0;
+      for (const BaseNode* node = fakeNode.next; node != &fakeNode;
+           node = node->next) {
+        ++count;
+      }
+      return count;
+    }
+  }
+
+  T& front() { return *owner_of(fakeNode.next); }
+
+  T& back() { return *owner_of(fakeNode.prev); }
+
+  void push_back(T& value) { link_before(&fakeNode, hook_of(value)); }
+
+  void push_front(T& value) { link_before(fakeNode.next, hook_of(value)); }
+
+  void pop_back() { unlink_node(fakeNode.prev); }
+
+  void pop_front() { unlink_node(fakeNode.next); }
+
+  template <bool is_const>
+  iterator insert(Intrusive_Iterator<is_const> it, T& value) {
+    link_before(it.node, hook_of(value));
+    return {hook_of(value)};
+  }
+
+  template <bool is_const>
+  iterator erase(Intrusive_Iterator<is_const> it) {
+    BaseNode* next_node = it.node->next;
+    unlink_node(it.node);
+    return {next_node};
+  }
+
+  void erase(T& value) { unlink_node(hook_of(value)); }
+
+  void clear() {
+    while (!empty()) {
+      fakeNode.next->unlink();
+    }
+    size_ = 0;
+  }
+};
@@ -1,55 +1,444 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-template <size_t N>
+#include "ForEachPool.cpp"
+
+struct NoArenaStats {
+  void on_allocate(size_t, size_t, size_t) {}
+  void on_rewind(size_t) {}
+  void on_destroy(size_t) {}
+};
+
+struct ArenaStats {
+  static constexpr size_t histogram_size = 32;
+
+  size_t bytes_used = 0;
+  size_t peak_shift = 0;
+  size_t padding_bytes = 0;
+  size_t allocations_count = 0;
+  size_t histogram[histogram_size] = {};
+  std::ostream* report_stream = nullptr;
+
+  static size_t bucket(size_t count) {
+    size_t result = 0;
+    while (count > 1 && result + 1 < histogram_size) {
+      count >>= 1;
+      ++result;
+    }
+    return result;
+  }
+
+  void on_allocate(size_t count, size_t padding, size_t shift) {
+    bytes_used = shift;
+    peak_shift = std::max(peak_shift, shift);
+    padding_bytes += padding;
+    ++allocations_count;
+    ++histogram[bucket(count)];
+  }
+
+  void on_rewind(size_t shift) { bytes_used = shift; }
+
+  void report(std::ostream& out, size_t capacity) const {
+    out << "arena: " << bytes_used << " / " << capacity << " bytes used, peak "
+        << peak_shift << ", padding " << padding_bytes << ", allocations "
+        << allocations_count << '\n';
+    for (size_t i = 0; i < histogram_size; ++i) {
+      if (histogram[i] != 0) {
+        out << "  [" << (size_t(1) << i) << ", " << (size_t(1) << (i + 1))
+            << "): " << histogram[i] << '\n';
+      }
+    }
+  }
+
+  void on_destroy(size_t capacity) {
+    if (report_stream != nullptr) {
+      report(*report_stream, capacity);
+    }
+  }
+};
+
+template <size_t N, typename Stats = NoArenaStats>
 class StackStorage {
  private:
   char array[N];
   size_t shift;
+  [[no_unique_address]] Stats statistics;
+  std::vector<size_t> live_blocks;
 
  public:
+  using is_monotonic = std::true_type;
+
+  struct Marker {
+    size_t shift;
+  };
+
+  class Scope {
+   private:
+    StackStorage& storage;
+    Marker marker;
+
+   public:
+    Scope(StackStorage& storage)
+        : storage(storage), marker(storage.checkpoint()) {}
+
+    Scope(const Scope& src) = delete;
+    Scope& operator=(const Scope& src) = delete;
+
+    ~Scope() { storage.rewind(marker); }
+  };
+
   StackStorage() : shift(0) {}
 
   StackStorage(const StackStorage& src) = delete;
 
   void* allocate(size_t count, size_t align) {
-    if (shift + count > N) {
+    std::size_t space = N - shift;
+    void* ptr = static_cast<char*>(array) + shift;
+    if (std::align(align, count, ptr, space) == nullptr) {
+      throw std::bad_alloc();
+    }
+    size_t padding = N - space - shift;
+    shift = N - space + count;
+    statistics.on_allocate(count, padding, shift);
+#ifndef NDEBUG
+    live_blocks.push_back(shift - count);
+#endif
+    return ptr;
+  }
+
+  void* allocate_bulk(size_t count, size_t size, size_t align) {
+    void* ptr = allocate(count * size, align);
+#ifndef NDEBUG
+    size_t offset = static_cast<char*>(ptr) - array;
+    for (size_t i = 1; i < count; ++i) {
+      live_blocks.push_back(offset + i * size);
+    }
+#endif
+    return ptr;
+  }
+
+  void deallocate(void* ptr, size_t, size_t) {
+#ifndef NDEBUG
+    auto block = std::upper_bound(live_blocks.begin(), live_blocks.end(),
+                                  size_t(static_cast<char*>(ptr) - array));
+    if (block != live_blocks.begin() &&
+        *(block - 1) == size_t(static_cast<char*>(ptr) - array)) {
+      live_blocks.erase(block - 1);
+    }
+#else
+    std::ignore = ptr;
+#endif
+  }
+
+  Marker checkpoint() const { return {shift}; }
+
+  void rewind(Marker marker) {
+    assert(marker.shift <= shift && "rewind past a newer checkpoint");
+#ifndef NDEBUG
+    assert((live_blocks.empty() || live_blocks.back() < marker.shift) &&
+           "rewind over memory still owned by a live container");
+#endif
+    shift = marker.shift;
+    statistics.on_rewind(shift);
+  }
+
+  Stats& stats() { return statistics; }
+
+  const Stats& stats() const { return statistics; }
+
+  StackStorage& operator=(const StackStorage& src) = delete;
+
+  ~StackStorage() { statistics.on_destroy(N); }
+};
+
+template <size_t N, typename Upstream = std::allocator<char>>
+class ChainedStackStorage {
+ private:
+  struct Chunk {
+    Chunk* prev;
+    size_t size;
+  };
+
+  using ChunkAlloc =
+      typename std::allocator_traits<Upstream>::template rebind_alloc<char>;
+
+  char array[N];
+  char* current;
+  size_t capacity;
+  size_t shift;
+  size_t next_capacity;
+  Chunk* last_chunk;
+  ChunkAlloc upstream;
+
+  void* allocate_in_new_chunk(size_t count, size_t align) {
+    size_t data_size = std::max(next_capacity, count + align);
+    size_t chunk_size = sizeof(Chunk) + alignof(std::max_align_t) + data_size;
+    char* raw = std::allocator_traits<ChunkAlloc>::allocate(upstream, chunk_size);
+    Chunk* chunk = new (raw) Chunk{last_chunk, chunk_size};
+    last_chunk = chunk;
+    current = raw + sizeof(Chunk);
+    capacity = chunk_size - sizeof(Chunk);
+    shift = 0;
+    next_capacity = data_size * 2;
+
+    std::size_t space = capacity;
+    void* ptr = current;
+    std::align(align, count, ptr, space);
+    shift = capacity - space + count;
+    return ptr;
+  }
+
+ public:
+  using is_monotonic = std::true_type;
+
+  ChainedStackStorage(const Upstream& upstream = Upstream())
+      : current(array),
+        capacity(N),
+        shift(0),
+        next_capacity(N > 0 ? 2 * N : 64),
+        last_chunk(nullptr),
+        upstream(upstream) {}
+
+  ChainedStackStorage(const ChainedStackStorage& src) = delete;
+
+  void* allocate(size_t count, size_t align) {
+    std::size_t space = capacity - shift;
+    void* ptr = current + shift;
+    if (std::align(align, count, ptr, space) == nullptr) {
+      return allocate_in_new_chunk(count, align);
+    }
+    shift = capacity - space + count;
+    return ptr;
+  }
+
+  size_t chunks_count() const {
+    size_t count = 0;
+    for (Chunk* chunk = last_chunk; chunk != nullptr; chunk = chunk->prev) {
+      ++count;
+    }
+    return count;
+  }
+
+  ChainedStackStorage& operator=(const ChainedStackStorage& src) = delete;
+
+  ~ChainedStackStorage() {
+    while (last_chunk != nullptr) {
+      Chunk* prev = last_chunk->prev;
+      size_t chunk_size = last_chunk->size;
+      std::allocator_traits<ChunkAlloc>::deallocate(
+          upstream, reinterpret_cast<char*>(last_chunk), chunk_size);
+      last_chunk = prev;
+    }
+  }
+};
+
+template <size_t N>
+class AtomicStackStorage {
+ private:
+  alignas(std::max_align_t) char array[N];
+  std::atomic<size_t> shift;
+
+ public:
+  using is_monotonic = std::true_type;
+
+  AtomicStackStorage() : shift(0) {}
+
+  AtomicStackStorage(const AtomicStackStorage& src) = delete;
+
+  void* allocate(size_t count, size_t align) {
+    size_t reserved = count + align - 1;
+    size_t begin = shift.fetch_add(reserved, std::memory_order_relaxed);
+    if (begin > N || reserved > N - begin) {
       throw std::bad_alloc();
-    } else {
-      std::size_t space = N;
-      void* ptr = static_cast<char*>(array) + shift;
-      std::align(align, count, ptr, space);
-      shift += count;
-      return ptr;
     }
+    std::size_t space = reserved;
+    void* ptr = static_cast<char*>(array) + begin;
+    std::align(align, count, ptr, space);
+    return ptr;
   }
 
-  StackStorage& operator=(const StackStorage<N>& src) = delete;
+  bool give_back(void* first, void* last) {
+    size_t expected = static_cast<char*>(last) - array;
+    return shift.compare_exchange_strong(expected,
+                                         static_cast<char*>(first) - array,
+                                         std::memory_order_relaxed);
+  }
+
+  AtomicStackStorage& operator=(const AtomicStackStorage& src) = delete;
 };
 
-template <typename T, size_t N>
+template <size_t N, size_t ChunkSize = 4096>
+class ThreadLocalStackStorage {
+ private:
+  struct LocalChunk {
+    size_t owner_id = 0;
+    char* current = nullptr;
+    char* end = nullptr;
+  };
 
+  static constexpr size_t cache_slots = 8;
+
+  static inline std::atomic<size_t> next_id{1};
+  static inline thread_local LocalChunk locals[cache_slots];
+
+  AtomicStackStorage<N> pool;
+  size_t id;
+
+  LocalChunk& local_chunk() {
+    for (size_t i = 0; i < cache_slots; ++i) {
+      if (locals[i].owner_id == id) {
+        std::rotate(locals, locals + i, locals + i + 1);
+        return locals[0];
+      }
+    }
+    std::rotate(locals, locals + cache_slots - 1, locals + cache_slots);
+    locals[0] = LocalChunk();
+    return locals[0];
+  }
+
+ public:
+  using is_monotonic = std::true_type;
+
+  ThreadLocalStackStorage()
+      : id(next_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+  ThreadLocalStackStorage(const ThreadLocalStackStorage& src) = delete;
+
+  void* allocate(size_t count, size_t align) {
+    if (count + align > ChunkSize) {
+      return pool.allocate(count, align);
+    }
+    LocalChunk& local = local_chunk();
+    if (local.owner_id == id) {
+      std::size_t space = local.end - local.current;
+      void* ptr = local.current;
+      if (std::align(align, count, ptr, space) != nullptr) {
+        local.current = static_cast<char*>(ptr) + count;
+        return ptr;
+      }
+      pool.give_back(local.current, local.end);
+    }
+    char* chunk = static_cast<char*>(pool.allocate(ChunkSize, 1));
+    local.owner_id = id;
+    local.end = chunk + ChunkSize;
+    std::size_t space = ChunkSize;
+    void* ptr = chunk;
+    std::align(align, count, ptr, space);
+    local.current = static_cast<char*>(ptr) + count;
+    return ptr;
+  }
+
+  ThreadLocalStackStorage& operator=(const ThreadLocalStackStorage& src) =
+      delete;
+};
+
+template <typename Storage, size_t MaxRecycledSize = 256>
+class RecyclingStackStorage {
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static constexpr size_t granularity = sizeof(FreeBlock);
+  static constexpr size_t classes_count =
+      (MaxRecycledSize + granularity - 1) / granularity;
+
+  Storage storage;
+  FreeBlock* free_lists[classes_count] = {};
+
+  static size_t size_class(size_t count) {
+    return count == 0 ? 0 : (count - 1) / granularity;
+  }
+
+ public:
+  using is_monotonic = std::false_type;
+
+  template <typename... Args>
+    requires(!(std::is_same_v<std::remove_cvref_t<Args>,
+                              RecyclingStackStorage> ||
+               ...))
+  RecyclingStackStorage(Args&&... args) : storage(std::forward<Args>(args)...) {}
+
+  RecyclingStackStorage(const RecyclingStackStorage& src) = delete;
+
+  void* allocate(size_t count, size_t align) {
+    size_t cls = size_class(count);
+    if (cls >= classes_count) {
+      return storage.allocate(count, align);
+    }
+    for (FreeBlock** link = &free_lists[cls]; *link != nullptr;
+         link = &(*link)->next) {
+      FreeBlock* block = *link;
+      if (reinterpret_cast<uintptr_t>(block) % align == 0) {
+        *link = block->next;
+        return block;
+      }
+    }
+    return storage.allocate((cls + 1) * granularity,
+                            std::max(align, alignof(FreeBlock)));
+  }
+
+  void deallocate(void* ptr, size_t count, size_t) {
+    size_t cls = size_class(count);
+    if (ptr == nullptr || cls >= classes_count) {
+      return;
+    }
+    FreeBlock* block = new (ptr) FreeBlock{free_lists[cls]};
+    free_lists[cls] = block;
+  }
+
+  RecyclingStackStorage& operator=(const RecyclingStackStorage& src) = delete;
+};
+
+template <typename Alloc>
+struct is_monotonic_allocator : std::false_type {};
+
+template <typename Alloc>
+  requires requires { Alloc::is_monotonic::value; }
+struct is_monotonic_allocator<Alloc>
+    : std::bool_constant<Alloc::is_monotonic::value> {};
+
+template <typename T, size_t N, typename Storage = StackStorage<N>>
 class StackAllocator {
  public:
-  StackStorage<N>* storage;
+  Storage* storage;
 
  public:
-  template <typename T1>
-  friend bool operator==(StackAllocator<T1, N>& a, StackAllocator<T1, N>& b);
+  template <typename T1, size_t N1, typename Storage1>
+  friend bool operator==(const StackAllocator<T1, N1, Storage1>& a,
+                         const StackAllocator<T1, N1, Storage1>& b);
   using value_type = T;
   template <class U>
   struct rebind {
-    using other = StackAllocator<U, N>;
+    using other = StackAllocator<U, N, Storage>;
   };
   template <typename U>
-  StackAllocator(StackAllocator<U, N> allocator) : storage(allocator.storage) {}
-  StackAllocator(StackStorage<N>& src) : storage(&src) {}
-  StackAllocator(const StackAllocator<T, N>& src) : storage(src.storage) {}
+  StackAllocator(StackAllocator<U, N, Storage> allocator)
+      : storage(allocator.storage) {}
+  StackAllocator(Storage& src) : storage(&src) {}
+  StackAllocator(const StackAllocator<T, N, Storage>& src)
+      : storage(src.storage) {}
 
-  StackAllocator select_on_container_copy_construction()  {
-    return StackAllocator(&storage);
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_monotonic =
+      std::bool_constant<is_monotonic_allocator<Storage>::value>;
+
+  StackAllocator select_on_container_copy_construction() const {
+    return *this;
   }
 
   StackAllocator(StackAllocator& src) = default;
@@ -66,8 +455,29 @@ class StackAllocator {
     }
   }
 
-  void deallocate(T* ptr, size_t) {
-    std::ignore = ptr;
+  T* allocate_bulk(size_t count)
+    requires(sizeof(T) % sizeof(void*) == 0)
+  {
+    if constexpr (requires {
+                    storage->allocate_bulk(count, sizeof(T), alignof(T));
+                  }) {
+      try {
+        return static_cast<T*>(
+            storage->allocate_bulk(count, sizeof(T), alignof(T)));
+      } catch (...) {
+        throw std::bad_alloc();
+      }
+    } else {
+      return allocate(count);
+    }
+  }
+
+  void deallocate(T* ptr, size_t count) {
+    if constexpr (requires { storage->deallocate(ptr, count, alignof(T)); }) {
+      storage->deallocate(ptr, count * sizeof(T), alignof(T));
+    } else {
+      std::ignore = ptr;
+    }
   }
 
   void construct(T* ptr, T& value) { new (ptr) T(value); }
@@ -76,13 +486,213 @@ class StackAllocator {
 
 };
 
-template <typename T1, size_t N>
-bool operator==(StackAllocator<T1, N>& a, StackAllocator<T1, N>& b) {
+template <typename T1, size_t N, typename Storage>
+bool operator==(const StackAllocator<T1, N, Storage>& a,
+                const StackAllocator<T1, N, Storage>& b) {
   return a.storage == b.storage;
 }
 
-template <typename T, size_t N>
-bool operator!=(StackAllocator<T, N>& a, StackAllocator<T, N>& b) {
+template <typename T, size_t N, typename Storage>
+bool operator!=(const StackAllocator<T, N, Storage>& a,
+                const StackAllocator<T, N, Storage>& b) {
+  return !(a == b);
+}
+
+class NodePool {
+ private:
+  static constexpr size_t cache_line = 64;
+
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  struct alignas(cache_line) Slab {
+    Slab* prev;
+    Slab* next;
+    FreeNode* free_nodes;
+    char* unused;
+    size_t live;
+  };
+
+  size_t stride;
+  size_t nodes_per_slab;
+  size_t slab_bytes;
+  Slab* available;
+  Slab* empty_slab;
+
+  static size_t round_up(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+  }
+
+  char* slab_end(Slab* slab) const {
+    return reinterpret_cast<char*>(slab) + sizeof(Slab) +
+           stride * nodes_per_slab;
+  }
+
+  Slab* slab_of(void* ptr) const {
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) &
+                                   ~(slab_bytes - 1));
+  }
+
+  void link(Slab* slab) {
+    slab->prev = nullptr;
+    slab->next = available;
+    if (available != nullptr) {
+      available->prev = slab;
+    }
+    available = slab;
+  }
+
+  void unlink(Slab* slab) {
+    if (slab->prev != nullptr) {
+      slab->prev->next = slab->next;
+    } else {
+      available = slab->next;
+    }
+    if (slab->next != nullptr) {
+      slab->next->prev = slab->prev;
+    }
+  }
+
+  Slab* new_slab() {
+    Slab* slab;
+    if (empty_slab != nullptr) {
+      slab = empty_slab;
+      empty_slab = nullptr;
+    } else {
+      slab = static_cast<Slab*>(
+          ::operator new(slab_bytes, std::align_val_t(slab_bytes)));
+    }
+    slab->free_nodes = nullptr;
+    slab->unused = reinterpret_cast<char*>(slab) + sizeof(Slab);
+    slab->live = 0;
+    link(slab);
+    return slab;
+  }
+
+  void release(Slab* slab) {
+    ::operator delete(slab, std::align_val_t(slab_bytes));
+  }
+
+ public:
+  static size_t stride_for(size_t size, size_t align) {
+    return round_up(std::max(size, sizeof(FreeNode)),
+                    std::max(align, alignof(FreeNode)));
+  }
+
+  NodePool(size_t size, size_t align, size_t nodes_per_slab)
+      : stride(stride_for(size, align)),
+        nodes_per_slab(nodes_per_slab),
+        slab_bytes(cache_line),
+        available(nullptr),
+        empty_slab(nullptr) {
+    while (slab_bytes < sizeof(Slab) + stride * nodes_per_slab) {
+      slab_bytes *= 2;
+    }
+  }
+
+  NodePool(const NodePool& src) = delete;
+
+  size_t node_size() const { return stride; }
+
+  void* allocate() {
+    Slab* slab = available != nullptr ? available : new_slab();
+    void* ptr;
+    if (slab->free_nodes != nullptr) {
+      ptr = slab->free_nodes;
+      slab->free_nodes = slab->free_nodes->next;
+    } else {
+      ptr = slab->unused;
+      slab->unused += stride;
+    }
+    ++slab->live;
+    if (slab->free_nodes == nullptr && slab->unused == slab_end(slab)) {
+      unlink(slab);
+    }
+    return ptr;
+  }
+
+  void deallocate(void* ptr) {
+    Slab* slab = slab_of(ptr);
+    bool was_full = slab->free_nodes == nullptr && slab->unused == slab_end(slab);
+    slab->free_nodes = new (ptr) FreeNode{slab->free_nodes};
+    --slab->live;
+    if (!was_full) {
+      unlink(slab);
+    }
+    if (slab->live != 0) {
+      link(slab);
+    } else if (empty_slab == nullptr) {
+      empty_slab = slab;
+    } else {
+      release(slab);
+    }
+  }
+
+  NodePool& operator=(const NodePool& src) = delete;
+
+  ~NodePool() {
+    while (available != nullptr) {
+      Slab* next = available->next;
+      release(available);
+      available = next;
+    }
+    if (empty_slab != nullptr) {
+      release(empty_slab);
+    }
+  }
+};
+
+template <typename T, size_t NodesPerSlab = 256>
+class NodePoolAllocator {
+  static_assert(NodesPerSlab >= 64 && NodesPerSlab <= 4096);
+
+ public:
+  std::shared_ptr<NodePool> pool;
+
+ public:
+  using value_type = T;
+  template <class U>
+  struct rebind {
+    using other = NodePoolAllocator<U, NodesPerSlab>;
+  };
+
+  NodePoolAllocator()
+      : pool(std::make_shared<NodePool>(sizeof(T), alignof(T), NodesPerSlab)) {}
+
+  template <typename U>
+  NodePoolAllocator(const NodePoolAllocator<U, NodesPerSlab>& allocator)
+      : pool(allocator.pool->node_size() ==
+                     NodePool::stride_for(sizeof(T), alignof(T))
+                 ? allocator.pool
+                 : std::make_shared<NodePool>(sizeof(T), alignof(T),
+                                              NodesPerSlab)) {}
+
+  T* allocate(size_t count) {
+    if (count == 1) {
+      return static_cast<T*>(pool->allocate());
+    }
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* ptr, size_t count) {
+    if (count == 1) {
+      pool->deallocate(ptr);
+    } else {
+      std::allocator<T>().deallocate(ptr, count);
+    }
+  }
+};
+
+template <typename T1, typename T2, size_t NodesPerSlab>
+bool operator==(const NodePoolAllocator<T1, NodesPerSlab>& a,
+                const NodePoolAllocator<T2, NodesPerSlab>& b) {
+  return a.pool == b.pool;
+}
+
+template <typename T1, typename T2, size_t NodesPerSlab>
+bool operator!=(const NodePoolAllocator<T1, NodesPerSlab>& a,
+                const NodePoolAllocator<T2, NodesPerSlab>& b) {
   return !(a == b);
 }
 
@@ -94,6 +704,8 @@ class List {
     T value;
     Node(const T& value) : BaseNode(), value(value)  {}
     Node() : BaseNode(), value(T()) {}
+    template <typename... Args>
+    Node(Args&&... args) : BaseNode(), value(std::forward<Args>(args)...) {}
   };
 
   struct BaseNode {
@@ -118,67 +730,23 @@ class List {
   List(Alloc allocator) : node_alloc_(allocator), fakeNode() {}
 
   List(size_t count, const T& value, Alloc allocator)
-      :  size_(count), node_alloc_(allocator), fakeNode() {
-    BaseNode* node = &fakeNode;
-    size_t times = 1;
-    Node* next_node;
-    try {
-      for (; times <= count; ++times) {
-        next_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
-        std::allocator_traits<NodeAlloc>::construct(node_alloc_, next_node,
-                                                    value);
-        node->next = next_node;
-        next_node->prev = static_cast<Node*>(node);
-        node = next_node;
-      }
-      node->next = static_cast<Node*>(&fakeNode);
-      fakeNode.prev = static_cast<Node*>(node);
-    } catch (...) {
-      BaseNode* prev_node = node->prev;
-      std::allocator_traits<NodeAlloc>::deallocate(node_alloc_,
-                                                   static_cast<Node*>(node), 1);
-      node = prev_node;
-      for (size_t i = 1; i < times; ++i) {
-        prev_node = node->prev;
-        std::allocator_traits<NodeAlloc>::destroy(node_alloc_,
-                                                  static_cast<Node*>(node));
-        std::allocator_traits<NodeAlloc>::deallocate(
-            node_alloc_, static_cast<Node*>(node), 1);
-        node = prev_node;
-      }
-      throw;
-    }
+      : node_alloc_(allocator), fakeNode() {
+    link_chain(&fakeNode, make_chain(count, [&](Node* node) {
+                 std::allocator_traits<NodeAlloc>::construct(node_alloc_, node,
+                                                             value);
+               }));
   }
 
-  List(size_t count, Alloc allocator)
-      : size_(count), node_alloc_(allocator), fakeNode() {
-    BaseNode* node = &fakeNode;
-    size_t times = 1;
-    Node* next_node;
-    try {
-      for (; times <= count; ++times) {
-        next_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
-        std::allocator_traits<NodeAlloc>::construct(node_alloc_, next_node);
-        node->next = next_node;
-        next_node->prev = static_cast<Node*>(node);
-        node = next_node;
-      }
-      node->next = static_cast<Node*>(&fakeNode);
-      fakeNode.prev = static_cast<Node*>(node);
-    } catch (...) {
-      BaseNode* prev_node;
-      std::allocator_traits<NodeAlloc>::deallocate(
-          node_alloc_, static_cast<Node*>(next_node), 1);
-      for (size_t i = 1; i < times; ++i) {
-        prev_node = node->prev;
-        std::allocator_traits<NodeAlloc>::destroy(node_alloc_,
-                                                  static_cast<Node*>(node));
-        std::allocator_traits<NodeAlloc>::deallocate(
-            node_alloc_, static_cast<Node*>(node), 1);
-        node = prev_node;
-      }
-      throw;
-    }
+  List(size_t count, Alloc allocator) : node_alloc_(allocator), fakeNode() {
+    link_chain(&fakeNode, make_chain(count, [&](Node* node) {
+                 std::allocator_traits<NodeAlloc>::construct(node_alloc_, node);
+               }));
+  }
+
+  template <std::input_iterator InputIt>
+  List(InputIt first, InputIt last, Alloc allocator = Alloc())
+      : node_alloc_(allocator), fakeNode() {
+    link_chain(&fakeNode, make_chain(first, last));
   }
 
   List(size_t count, const T& value)
@@ -225,17 +793,74 @@ class List {
     }
   }
 
-  List& operator=(List& other) {
-    if (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value) {
+  List(List&& other) noexcept
+      : size_(0), node_alloc_(other.node_alloc_), fakeNode() {
+    take_nodes(other);
+  }
+
+  List& operator=(const List& other) {
+    if (&other == this) {
+      return *this;
+    }
+    destroy_nodes();
+    if constexpr (std::allocator_traits<
+                      NodeAlloc>::propagate_on_container_copy_assignment::value) {
+      node_alloc_ = other.node_alloc_;
+    }
+    BaseNode* other_node = other.fakeNode.next;
+    link_chain(&fakeNode, make_chain(other.size_, [&](Node* node) {
+                 std::allocator_traits<NodeAlloc>::construct(
+                     node_alloc_, node, static_cast<Node*>(other_node)->value);
+                 other_node = other_node->next;
+               }));
+    return *this;
+  }
+
+  List& operator=(List&& other) noexcept(
+      std::allocator_traits<NodeAlloc>::propagate_on_container_move_assignment::value ||
+      std::allocator_traits<NodeAlloc>::is_always_equal::value) {
+    if (&other == this) {
+      return *this;
+    }
+    destroy_nodes();
+    if constexpr (std::allocator_traits<
+                      NodeAlloc>::propagate_on_container_move_assignment::value) {
       node_alloc_ = other.node_alloc_;
+      take_nodes(other);
+    } else {
+      if (node_alloc_ == other.node_alloc_) {
+        take_nodes(other);
+      } else {
+        for (BaseNode* node = other.fakeNode.next; node != &other.fakeNode;
+             node = node->next) {
+          emplace_back(std::move(static_cast<Node*>(node)->value));
+        }
+      }
     }
-    List tmp(other);
-    std::swap(size_, tmp.size_);
-    std::swap(fakeNode, tmp.fakeNode);
     return *this;
   }
 
-  ~List() {
+  ~List() { destroy_nodes(); }
+
+  void clear() { destroy_nodes(); }
+
+ private:
+  void destroy_nodes() {
+    if constexpr (std::is_trivially_destructible_v<Node> &&
+                  is_monotonic_allocator<NodeAlloc>::value) {
+#ifndef NDEBUG
+      for (BaseNode* node = fakeNode.next; node != &fakeNode;) {
+        BaseNode* next_node = node->next;
+        std::allocator_traits<NodeAlloc>::deallocate(
+            node_alloc_, static_cast<Node*>(node), 1);
+        node = next_node;
+      }
+#endif
+      fakeNode.next = &fakeNode;
+      fakeNode.prev = &fakeNode;
+      size_ = 0;
+      return;
+    }
     BaseNode* node = fakeNode.next;
     BaseNode* next_node;
     for (size_t i = 1; i <= size_; ++i) {
@@ -246,15 +871,131 @@ class List {
                                                    static_cast<Node*>(node), 1);
       node = next_node;
     }
-    fakeNode = BaseNode();
+    fakeNode.next = &fakeNode;
+    fakeNode.prev = &fakeNode;
+    size_ = 0;
   }
 
-  void push_back(const T& value) {
+  struct Chain {
+    BaseNode* first;
+    BaseNode* last;
+    size_t count;
+  };
+
+  template <typename Construct>
+  Chain make_chain(size_t count, Construct construct) {
+    if (count == 0) {
+      return {nullptr, nullptr, 0};
+    }
+    Node* block = nullptr;
+    if constexpr (requires(NodeAlloc& alloc) { alloc.allocate_bulk(count); }) {
+      block = node_alloc_.allocate_bulk(count);
+    }
+    BaseNode head;
+    BaseNode* tail = &head;
+    size_t constructed = 0;
+    try {
+      for (; constructed < count; ++constructed) {
+        Node* node = block != nullptr
+                         ? block + constructed
+                         : std::allocator_traits<NodeAlloc>::allocate(
+                               node_alloc_, 1);
+        try {
+          construct(node);
+        } catch (...) {
+          if (block == nullptr) {
+            std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, node, 1);
+          }
+          throw;
+        }
+        tail->next = node;
+        node->prev = tail;
+        tail = node;
+      }
+    } catch (...) {
+      BaseNode* node = head.next;
+      for (size_t i = 0; i < constructed; ++i) {
+        BaseNode* next_node = node->next;
+        std::allocator_traits<NodeAlloc>::destroy(node_alloc_,
+                                                  static_cast<Node*>(node));
+        std::allocator_traits<NodeAlloc>::deallocate(
+            node_alloc_, static_cast<Node*>(node), 1);
+        node = next_node;
+      }
+      if (block != nullptr) {
+        for (size_t i = constructed; i < count; ++i) {
+          std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, block + i,
+                                                       1);
+        }
+      }
+      throw;
+    }
+    return {head.next, tail, count};
+  }
+
+  template <std::input_iterator InputIt>
+  Chain make_chain(InputIt first, InputIt last) {
+    if constexpr (std::forward_iterator<InputIt>) {
+      return make_chain(std::distance(first, last), [&](Node* node) {
+        std::allocator_traits<NodeAlloc>::construct(node_alloc_, node, *first);
+        ++first;
+      });
+    } else {
+      List tmp(node_alloc_);
+      for (; first != last; ++first) {
+        tmp.emplace_back(*first);
+      }
+      Chain chain{tmp.fakeNode.next, tmp.fakeNode.prev, tmp.size_};
+      tmp.fakeNode.next = &tmp.fakeNode;
+      tmp.fakeNode.prev = &tmp.fakeNode;
+      tmp.size_ = 0;
+      return chain;
+    }
+  }
+
+  void link_chain(BaseNode* pos, Chain chain) {
+    if (chain.count == 0) {
+      return;
+    }
+    BaseNode* prev_node = pos->prev;
+    prev_node->next = chain.first;
+    chain.first->prev = prev_node;
+    chain.last->next = pos;
+    pos->prev = chain.last;
+    size_ += chain.count;
+  }
+
+  void take_nodes(List& other) {
+    if (other.size_ == 0) {
+      return;
+    }
+    fakeNode.next = other.fakeNode.next;
+    fakeNode.prev = other.fakeNode.prev;
+    fakeNode.next->prev = &fakeNode;
+    fakeNode.prev->next = &fakeNode;
+    other.fakeNode.next = &other.fakeNode;
+    other.fakeNode.prev = &other.fakeNode;
+    size_ = other.size_;
+    other.size_ = 0;
+  }
+
+ public:
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  void push_front(const T& value) { emplace_front(value); }
+
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
     Node* new_node;
     new_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
     try {
       BaseNode* prev_node = fakeNode.prev;
-      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node, value);
+      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node,
+                                                  std::forward<Args>(args)...);
       prev_node->next = new_node;
       new_node->prev = prev_node;
       fakeNode.prev = new_node;
@@ -266,12 +1007,14 @@ class List {
     }
   }
 
-  void push_front(const T& value) {
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
     Node* new_node;
     new_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
     try {
       BaseNode* next_node = fakeNode.next;
-      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node, value);
+      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node,
+                                                  std::forward<Args>(args)...);
       new_node->next = next_node;
       next_node->prev = new_node;
       fakeNode.next = new_node;
@@ -440,12 +1183,37 @@ class List {
 
   template <bool is_const>
   void insert(List_Iterator<is_const> it, const T& value) {
+    emplace(it, value);
+  }
+
+  template <bool is_const>
+  void insert(List_Iterator<is_const> it, T&& value) {
+    emplace(it, std::move(value));
+  }
+
+  template <bool is_const, std::input_iterator InputIt>
+  iterator insert(List_Iterator<is_const> it, InputIt first, InputIt last) {
+    Chain chain = make_chain(first, last);
+    link_chain(it.node, chain);
+    return iterator(chain.count == 0 ? it.node : chain.first);
+  }
+
+  template <std::input_iterator InputIt>
+  void assign(InputIt first, InputIt last) {
+    Chain chain = make_chain(first, last);
+    destroy_nodes();
+    link_chain(&fakeNode, chain);
+  }
+
+  template <bool is_const, typename... Args>
+  iterator emplace(List_Iterator<is_const> it, Args&&... args) {
     Node* new_node;
     new_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
     BaseNode* old_node = it.node;
     BaseNode* prev_node = old_node->prev;
     try {
-      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node, value);
+      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node,
+                                                  std::forward<Args>(args)...);
       prev_node->next = new_node;
       new_node->prev = prev_node;
       old_node->prev = new_node;
@@ -455,6 +1223,7 @@ class List {
       std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, new_node, 1);
       throw;
     }
+    return iterator(new_node);
   }
 
   template <bool is_const>
@@ -470,4 +1239,240 @@ class List {
     prev_node->next = next_node;
     next_node->prev = prev_node;
   }
+
+ private:
+  static void transfer(BaseNode* pos, BaseNode* first, BaseNode* last) {
+    if (pos == last || first == last) {
+      return;
+    }
+    BaseNode* last_node = last->prev;
+    first->prev->next = last;
+    last->prev = first->prev;
+    BaseNode* prev_node = pos->prev;
+    prev_node->next = first;
+    first->prev = prev_node;
+    last_node->next = pos;
+    pos->prev = last_node;
+  }
+
+  BaseNode* detach_chain() {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    BaseNode* chain = fakeNode.next;
+    fakeNode.prev->next = nullptr;
+    fakeNode.next = &fakeNode;
+    fakeNode.prev = &fakeNode;
+    return chain;
+  }
+
+  void attach_chain(BaseNode* chain) {
+    BaseNode* prev_node = fakeNode.prev;
+    for (; chain != nullptr; chain = chain->next) {
+      prev_node->next = chain;
+      chain->prev = prev_node;
+      prev_node = chain;
+    }
+    prev_node->next = &fakeNode;
+    fakeNode.prev = prev_node;
+  }
+
+  template <typename Compare>
+  static BaseNode* merge_chains(BaseNode*& first, BaseNode*& second,
+                                Compare& comp) {
+    BaseNode head;
+    BaseNode* tail = &head;
+    try {
+      while (first != nullptr && second != nullptr) {
+        if (comp(static_cast<Node*>(second)->value,
+                 static_cast<Node*>(first)->value)) {
+          tail->next = second;
+          second = second->next;
+        } else {
+          tail->next = first;
+          first = first->next;
+        }
+        tail = tail->next;
+      }
+    } catch (...) {
+      tail->next = first;
+      while (tail->next != nullptr) {
+        tail = tail->next;
+      }
+      tail->next = second;
+      first = head.next;
+      second = nullptr;
+      throw;
+    }
+    tail->next = first != nullptr ? first : second;
+    first = nullptr;
+    second = nullptr;
+    return head.next;
+  }
+
+ public:
+  template <bool is_const>
+  void splice(List_Iterator<is_const> pos, List& other) {
+    if (&other == this) {
+      return;
+    }
+    transfer(pos.node, other.fakeNode.next, &other.fakeNode);
+    size_ += other.size_;
+    other.size_ = 0;
+  }
+
+  template <bool is_const, bool is_const_other>
+  void splice(List_Iterator<is_const> pos, List& other,
+              List_Iterator<is_const_other> it) {
+    BaseNode* node = it.node;
+    if (pos.node == node || pos.node == node->next) {
+      return;
+    }
+    transfer(pos.node, node, node->next);
+    --other.size_;
+    ++size_;
+  }
+
+  template <bool is_const, bool is_const_other>
+  void splice(List_Iterator<is_const> pos, List& other,
+              List_Iterator<is_const_other> first,
+              List_Iterator<is_const_other> last) {
+    if (&other != this) {
+      size_t count = 0;
+      for (BaseNode* node = first.node; node != last.node; node = node->next) {
+        ++count;
+      }
+      other.size_ -= count;
+      size_ += count;
+    }
+    transfer(pos.node, first.node, last.node);
+  }
+
+  template <typename Compare>
+  void merge(List& other, Compare comp) {
+    if (&other == this) {
+      return;
+    }
+    BaseNode* first = detach_chain();
+    BaseNode* second = other.detach_chain();
+    size_ += other.size_;
+    other.size_ = 0;
+    try {
+      attach_chain(merge_chains(first, second, comp));
+    } catch (...) {
+      attach_chain(first);
+      throw;
+    }
+  }
+
+  void merge(List& other) { merge(other, std::less<T>()); }
+
+  template <typename Compare>
+  void sort(Compare comp) {
+    BaseNode* buckets[64] = {};
+    BaseNode* chain = detach_chain();
+    BaseNode* carry = nullptr;
+    BaseNode* result = nullptr;
+    try {
+      while (chain != nullptr) {
+        carry = chain;
+        chain = chain->next;
+        carry->next = nullptr;
+        size_t i = 0;
+        for (; buckets[i] != nullptr; ++i) {
+          carry = merge_chains(buckets[i], carry, comp);
+        }
+        buckets[i] = std::exchange(carry, nullptr);
+      }
+      for (BaseNode*& bucket : buckets) {
+        if (bucket != nullptr) {
+          result = merge_chains(bucket, result, comp);
+        }
+      }
+    } catch (...) {
+      attach_chain(chain);
+      attach_chain(carry);
+      attach_chain(result);
+      for (BaseNode* bucket : buckets) {
+        attach_chain(bucket);
+      }
+      throw;
+    }
+    attach_chain(result);
+  }
+
+  void sort() { sort(std::less<T>()); }
+
+  template <bool is_const, typename Func>
+  static void for_each_prefetched(List_Iterator<is_const> first,
+                                  List_Iterator<is_const> last, Func&& func) {
+    for (; first != last; ++first) {
+      __builtin_prefetch(first.node->next);
+      func(*first);
+    }
+  }
 };
+
+template <typename T, typename Alloc, typename Func>
+void for_each_prefetched(List<T, Alloc>& list, Func&& func) {
+  List<T, Alloc>::for_each_prefetched(list.begin(), list.end(), func);
+}
+
+template <typename T, typename Alloc, typename Func>
+void parallel_for_each(List<T, Alloc>& list, Func func,
+                       size_t segments_count = std::thread::hardware_concurrency()) {
+  using iterator = typename List<T, Alloc>::iterator;
+  segments_count = std::max<size_t>(1, std::min(segments_count, list.size()));
+  if (segments_count == 1) {
+    for_each_prefetched(list, func);
+    return;
+  }
+  std::vector<iterator> bounds;
+  bounds.reserve(segments_count + 1);
+  size_t segment_size = list.size() / segments_count;
+  size_t extra = list.size() % segments_count;
+  iterator it = list.begin();
+  for (size_t i = 0; i < segments_count; ++i) {
+    bounds.push_back(it);
+    for (size_t j = 0; j < segment_size + (i < extra ? 1 : 0); ++j) {
+      ++it;
+    }
+  }
+  bounds.push_back(list.end());
+
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t pending = segments_count - 1;
+  std::exception_ptr error;
+  ForEachPool& pool = ForEachPool::shared();
+  for (size_t i = 1; i < segments_count; ++i) {
+    pool.submit([&, i] {
+      std::exception_ptr segment_error;
+      try {
+        List<T, Alloc>::for_each_prefetched(bounds[i], bounds[i + 1], func);
+      } catch (...) {
+        segment_error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (segment_error && !error) {
+        error = std::move(segment_error);
+      }
+      if (--pending == 0) {
+        done.notify_one();
+      }
+    });
+  }
+  try {
+    List<T, Alloc>::for_each_prefetched(bounds[0], bounds[1], func);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex);
+    error = std::current_exception();
+  }
+  while (pool.run_pending()) {
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return pending == 0; });
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
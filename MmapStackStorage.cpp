@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+
+template <size_t N>
+class MmapStackStorage {
+ private:
+  static constexpr size_t huge_page_size = size_t(2) << 20;
+
+  char* mapping;
+  size_t mapping_size;
+  char* array;
+  size_t shift;
+  size_t committed;
+  size_t commit_step;
+
+  void commit(size_t needed) {
+    size_t new_committed =
+        std::min(N, (needed + commit_step - 1) / commit_step * commit_step);
+    if (mprotect(array + committed, new_committed - committed,
+                 PROT_READ | PROT_WRITE) != 0) {
+      throw std::bad_alloc();
+    }
+    committed = new_committed;
+  }
+
+ public:
+  using is_monotonic = std::true_type;
+
+  MmapStackStorage(bool use_huge_pages = false)
+      : mapping(nullptr),
+        mapping_size(N + (use_huge_pages ? huge_page_size : 0)),
+        array(nullptr),
+        shift(0),
+        committed(0),
+        commit_step(use_huge_pages ? huge_page_size : size_t(64) << 10) {
+    void* ptr = mmap(nullptr, mapping_size, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (ptr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    mapping = static_cast<char*>(ptr);
+    array = mapping;
+    if (use_huge_pages) {
+      uintptr_t address = reinterpret_cast<uintptr_t>(mapping);
+      array = mapping + (huge_page_size - address % huge_page_size) %
+                            huge_page_size;
+#ifdef MADV_HUGEPAGE
+      madvise(array, N, MADV_HUGEPAGE);
+#endif
+    }
+  }
+
+  MmapStackStorage(const MmapStackStorage& src) = delete;
+
+  void* allocate(size_t count, size_t align) {
+    std::size_t space = N - shift;
+    void* ptr = array + shift;
+    if (std::align(align, count, ptr, space) == nullptr) {
+      throw std::bad_alloc();
+    }
+    size_t new_shift = N - space + count;
+    if (new_shift > committed) {
+      commit(new_shift);
+    }
+    shift = new_shift;
+    return ptr;
+  }
+
+  void reset() {
+    if (committed != 0) {
+      madvise(array, committed, MADV_DONTNEED);
+    }
+    shift = 0;
+  }
+
+  size_t committed_bytes() const { return committed; }
+
+  MmapStackStorage& operator=(const MmapStackStorage& src) = delete;
+
+  ~MmapStackStorage() { munmap(mapping, mapping_size); }
+};
@@ -0,0 +1,170 @@
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
+
+template <typename T, typename Alloc = std::allocator<T>>
+class MpscQueue {
+ private:
+  struct BaseNode {
+    std::atomic<BaseNode*> next;
+
+    BaseNode() : next(nullptr) {}
+  };
+
+  struct Node : BaseNode {
+    T value;
+
+    template <typename... Args>
+    Node(Args&&... args) : BaseNode(), value(std::forward<Args>(args)...) {}
+  };
+
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  NodeAlloc node_alloc_;
+  alignas(64) std::atomic<BaseNode*> head_;
+  alignas(64) BaseNode* tail_;
+  BaseNode* fakeNode;
+  BaseNode fakeNodes[2];
+
+  void push_node(BaseNode* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    BaseNode* prev_node = head_.exchange(node, std::memory_order_acq_rel);
+    prev_node->next.store(node, std::memory_order_release);
+  }
+
+  Node* pop_node() {
+    BaseNode* tail = tail_;
+    BaseNode* next_node = tail->next.load(std::memory_order_acquire);
+    if (tail == fakeNode) {
+      if (next_node == nullptr) {
+        return nullptr;
+      }
+      tail_ = next_node;
+      tail = next_node;
+      next_node = next_node->next.load(std::memory_order_acquire);
+    }
+    if (next_node != nullptr) {
+      tail_ = next_node;
+      return static_cast<Node*>(tail);
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    push_node(fakeNode);
+    next_node = tail->next.load(std::memory_order_acquire);
+    if (next_node != nullptr) {
+      tail_ = next_node;
+      return static_cast<Node*>(tail);
+    }
+    return nullptr;
+  }
+
+  static BaseNode* wait_next(BaseNode* node) {
+    BaseNode* next_node;
+    while ((next_node = node->next.load(std::memory_order_acquire)) ==
+           nullptr) {
+      std::this_thread::yield();
+    }
+    return next_node;
+  }
+
+  void free_node(Node* node) {
+    std::allocator_traits<NodeAlloc>::destroy(node_alloc_, node);
+    std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, node, 1);
+  }
+
+ public:
+  MpscQueue()
+      : head_(&fakeNodes[0]), tail_(&fakeNodes[0]), fakeNode(&fakeNodes[0]) {}
+
+  MpscQueue(Alloc allocator)
+      : node_alloc_(allocator),
+        head_(&fakeNodes[0]),
+        tail_(&fakeNodes[0]),
+        fakeNode(&fakeNodes[0]) {}
+
+  MpscQueue(const MpscQueue& src) = delete;
+  MpscQueue& operator=(const MpscQueue& src) = delete;
+
+  ~MpscQueue() {
+    while (Node* node = pop_node()) {
+      free_node(node);
+    }
+  }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    Node* new_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
+    try {
+      std::allocator_traits<NodeAlloc>::construct(node_alloc_, new_node,
+                                                  std::forward<Args>(args)...);
+    } catch (...) {
+      std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, new_node, 1);
+      throw;
+    }
+    push_node(new_node);
+  }
+
+  void push(const T& value) { emplace(value); }
+
+  void push(T&& value) { emplace(std::move(value)); }
+
+  bool try_pop(T& value) {
+    Node* node = pop_node();
+    if (node == nullptr) {
+      return false;
+    }
+    value = std::move(node->value);
+    free_node(node);
+    return true;
+  }
+
+  template <typename Consumer>
+  size_t pop_all(Consumer consume) {
+    BaseNode* first = tail_;
+    BaseNode* old_fake = fakeNode;
+    if (first == old_fake &&
+        old_fake->next.load(std::memory_order_acquire) == nullptr &&
+        head_.load(std::memory_order_acquire) == old_fake) {
+      return 0;
+    }
+    fakeNode = old_fake == &fakeNodes[0] ? &fakeNodes[1] : &fakeNodes[0];
+    fakeNode->next.store(nullptr, std::memory_order_relaxed);
+    BaseNode* last = head_.exchange(fakeNode, std::memory_order_acq_rel);
+    tail_ = fakeNode;
+
+    size_t count = 0;
+    BaseNode* node = first;
+    while (node != nullptr) {
+      BaseNode* next_node = node == last ? nullptr : wait_next(node);
+      if (node != old_fake) {
+        Node* value_node = static_cast<Node*>(node);
+        try {
+          consume(std::move(value_node->value));
+        } catch (...) {
+          free_node(value_node);
+          for (node = next_node; node != nullptr;) {
+            next_node = node == last ? nullptr : wait_next(node);
+            if (node != old_fake) {
+              free_node(static_cast<Node*>(node));
+            }
+            node = next_node;
+          }
+          throw;
+        }
+        free_node(value_node);
+        ++count;
+      }
+      node = next_node;
+    }
+    return count;
+  }
+
+  bool empty() const {
+    return tail_ == fakeNode &&
+           fakeNode->next.load(std::memory_order_acquire) == nullptr;
+  }
+};
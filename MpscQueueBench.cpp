@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "List.cpp"
+#include "MpscQueue.cpp"
+
+class LockedList {
+ private:
+  std::mutex mutex;
+  List<long> list;
+
+ public:
+  void push(long value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    list.push_back(value);
+  }
+
+  bool try_pop(long& value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (list.size() == 0) {
+      return false;
+    }
+    value = *list.begin();
+    list.pop_front();
+    return true;
+  }
+};
+
+struct BenchResult {
+  double seconds;
+  bool complete;
+};
+
+template <typename Queue, typename Drain>
+BenchResult run_bench(size_t producers_count, size_t items_per_producer,
+                      Drain drain) {
+  Queue queue;
+  size_t total = producers_count * items_per_producer;
+  long expected_sum = 0;
+  for (size_t i = 0; i < items_per_producer; ++i) {
+    expected_sum += static_cast<long>(i) * producers_count;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  producers.reserve(producers_count);
+  for (size_t p = 0; p < producers_count; ++p) {
+    producers.emplace_back([&] {
+      for (size_t i = 0; i < items_per_producer; ++i) {
+        queue.push(static_cast<long>(i));
+      }
+    });
+  }
+  size_t received = 0;
+  long sum = 0;
+  while (received < total) {
+    size_t drained = drain(queue, sum);
+    if (drained == 0) {
+      std::this_thread::yield();
+    }
+    received += drained;
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return {elapsed.count(), sum == expected_sum};
+}
+
+template <typename Queue>
+size_t drain_one_by_one(Queue& queue, long& sum) {
+  size_t count = 0;
+  long value;
+  while (queue.try_pop(value)) {
+    sum += value;
+    ++count;
+  }
+  return count;
+}
+
+size_t drain_all(MpscQueue<long>& queue, long& sum) {
+  return queue.pop_all([&sum](long value) { sum += value; });
+}
+
+void report(const char* name, size_t producers_count, size_t items_count,
+            BenchResult result) {
+  std::cout << "  " << name << ": "
+            << producers_count * items_count / result.seconds / 1e6
+            << " M items/s" << (result.complete ? "" : " FAILED") << '\n';
+}
+
+int main(int argc, char** argv) {
+  size_t items_per_producer =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+  size_t max_producers =
+      argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+               : std::max<size_t>(1, std::thread::hardware_concurrency());
+  bool ok = true;
+  for (size_t producers = 1; producers <= max_producers; ++producers) {
+    std::cout << producers << " producers:\n";
+    BenchResult locked = run_bench<LockedList>(
+        producers, items_per_producer, drain_one_by_one<LockedList>);
+    BenchResult popped = run_bench<MpscQueue<long>>(
+        producers, items_per_producer, drain_one_by_one<MpscQueue<long>>);
+    BenchResult batched =
+        run_bench<MpscQueue<long>>(producers, items_per_producer, drain_all);
+    report("mutex + List     ", producers, items_per_producer, locked);
+    report("MpscQueue try_pop", producers, items_per_producer, popped);
+    report("MpscQueue pop_all", producers, items_per_producer, batched);
+    ok = ok && locked.complete && popped.complete && batched.complete;
+  }
+  return ok ? 0 : 1;
+}
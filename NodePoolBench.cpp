@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "List.cpp"
+
+struct BenchResult {
+  double build_seconds;
+  double churn_seconds;
+  double traverse_seconds;
+  long checksum;
+};
+
+template <typename ListType>
+BenchResult run_bench(size_t nodes_count, size_t churn_passes) {
+  using clock = std::chrono::steady_clock;
+  uint32_t seed = 2463534242u;
+  auto next_random = [&seed] {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+  };
+
+  auto start = clock::now();
+  ListType list;
+  for (size_t i = 0; i < nodes_count; ++i) {
+    list.push_back(static_cast<long>(i));
+  }
+  auto built = clock::now();
+
+  for (size_t pass = 0; pass < churn_passes; ++pass) {
+    for (auto it = list.begin(); it != list.end();) {
+      uint32_t roll = next_random() % 4;
+      auto current = it;
+      ++it;
+      if (roll == 0) {
+        list.erase(current);
+      } else if (roll == 1) {
+        list.insert(current, static_cast<long>(next_random()));
+      }
+    }
+  }
+  auto churned = clock::now();
+
+  long checksum = 0;
+  for (size_t round = 0; round < 10; ++round) {
+    for (auto it = list.begin(); it != list.end(); ++it) {
+      checksum += *it;
+    }
+  }
+  auto traversed = clock::now();
+
+  return {std::chrono::duration<double>(built - start).count(),
+          std::chrono::duration<double>(churned - built).count(),
+          std::chrono::duration<double>(traversed - churned).count(),
+          checksum};
+}
+
+template <typename ListType>
+void report(const char* name, size_t nodes_count, size_t churn_passes) {
+  BenchResult result = run_bench<ListType>(nodes_count, churn_passes);
+  std::cout << name << ": build " << result.build_seconds * 1e3
+            << " ms, churn " << result.churn_seconds * 1e3
+            << " ms, 10 traversals " << result.traverse_seconds * 1e3
+            << " ms (checksum " << result.checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+  size_t nodes_count =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+  size_t churn_passes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+  report<List<long>>("std::allocator   ", nodes_count, churn_passes);
+  report<List<long, NodePoolAllocator<long>>>("NodePoolAllocator", nodes_count,
+                                              churn_passes);
+  return 0;
+}
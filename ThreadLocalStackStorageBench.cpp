@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "List.cpp"
+
+constexpr size_t arena_size = size_t(256) << 20;
+
+using ArenaStorage = ThreadLocalStackStorage<arena_size>;
+using ArenaAllocator = StackAllocator<long, arena_size, ArenaStorage>;
+
+template <typename MakeList>
+double run_threads(size_t threads_count, size_t nodes_per_thread,
+                   MakeList make_list) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  threads.reserve(threads_count);
+  for (size_t i = 0; i < threads_count; ++i) {
+    threads.emplace_back([&] {
+      auto list = make_list();
+      for (size_t j = 0; j < nodes_per_thread; ++j) {
+        list.push_back(static_cast<long>(j));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+  size_t nodes_per_thread =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 18;
+  size_t max_threads =
+      argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+               : std::max<size_t>(1, std::thread::hardware_concurrency());
+  for (size_t threads = 1; threads <= max_threads; ++threads) {
+    double heap_seconds = run_threads(threads, nodes_per_thread, [] {
+      return List<long>();
+    });
+    auto storage = std::make_unique<ArenaStorage>();
+    double arena_seconds = run_threads(threads, nodes_per_thread, [&] {
+      return List<long, ArenaAllocator>(ArenaAllocator(*storage));
+    });
+    double nodes = static_cast<double>(threads * nodes_per_thread);
+    std::cout << threads << " threads: std::allocator "
+              << nodes / heap_seconds / 1e6 << " M nodes/s, "
+              << "ThreadLocalStackStorage " << nodes / arena_seconds / 1e6
+              << " M nodes/s\n";
+  }
+  return 0;
+}
@@ -0,0 +1,395 @@
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+template <typename T, size_t K = (64 / sizeof(T) > 4 ? 64 / sizeof(T) : 4),
+          typename Alloc = std::allocator<T>>
+class UnrolledList {
+  static_assert(K >= 2);
+
+ private:
+  struct BaseNode {
+    BaseNode* prev;
+    BaseNode* next;
+
+    BaseNode() {
+      prev = &(*this);
+      next = &(*this);
+    }
+  };
+
+  struct Node : BaseNode {
+    size_t count;
+    alignas(T) unsigned char storage[K * sizeof(T)];
+
+    Node() : BaseNode(), count(0) {}
+
+    T* data() { return reinterpret_cast<T*>(storage); }
+
+    const T* data() const { return reinterpret_cast<const T*>(storage); }
+  };
+
+  using NodeAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  size_t size_ = 0;
+  NodeAlloc node_alloc_;
+  BaseNode fakeNode;
+
+  static Node* as_node(BaseNode* node) { return static_cast<Node*>(node); }
+
+  Node* create_node(BaseNode* before) {
+    Node* new_node = std::allocator_traits<NodeAlloc>::allocate(node_alloc_, 1);
+    new (new_node) Node();
+    BaseNode* prev_node = before->prev;
+    prev_node->next = new_node;
+    new_node->prev = prev_node;
+    before->prev = new_node;
+    new_node->next = before;
+    return new_node;
+  }
+
+  void destroy_node(Node* node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    for (size_t i = 0; i < node->count; ++i) {
+      node->data()[i].~T();
+    }
+    node->~Node();
+    std::allocator_traits<NodeAlloc>::deallocate(node_alloc_, node, 1);
+  }
+
+  void insert_into(Node* node, size_t index, const T& value) {
+    T* data = node->data();
+    if (index == node->count) {
+      new (data + index) T(value);
+      ++node->count;
+      ++size_;
+      return;
+    }
+    T copy(value);
+    new (data + node->count) T(std::move(data[node->count - 1]));
+    ++node->count;
+    ++size_;
+    for (size_t i = node->count - 2; i > index; --i) {
+      data[i] = std::move(data[i - 1]);
+    }
+    data[index] = std::move(copy);
+  }
+
+  Node* split(Node* node) {
+    Node* new_node = create_node(node->next);
+    size_t half = node->count / 2;
+    try {
+      for (; new_node->count < node->count - half; ++new_node->count) {
+        new (new_node->data() + new_node->count)
+            T(std::move(node->data()[half + new_node->count]));
+      }
+    } catch (...) {
+      destroy_node(new_node);
+      throw;
+    }
+    for (size_t i = half; i < node->count; ++i) {
+      node->data()[i].~T();
+    }
+    node->count = half;
+    return new_node;
+  }
+
+  void merge_with_next(Node* node) {
+    if (node->next == &fakeNode) {
+      return;
+    }
+    Node* next_node = as_node(node->next);
+    if (node->count + next_node->count > K) {
+      return;
+    }
+    size_t moved = 0;
+    try {
+      for (; moved < next_node->count; ++moved) {
+        new (node->data() + node->count + moved)
+            T(std::move(next_node->data()[moved]));
+      }
+    } catch (...) {
+      for (size_t i = 0; i < moved; ++i) {
+        node->data()[node->count + i].~T();
+      }
+      throw;
+    }
+    node->count += next_node->count;
+    destroy_node(next_node);
+  }
+
+  void copy_from(const UnrolledList& other) {
+    for (const BaseNode* node = other.fakeNode.next; node != &other.fakeNode;
+         node = node->next) {
+      const Node* other_node = static_cast<const Node*>(node);
+      Node* new_node = create_node(&fakeNode);
+      for (; new_node->count < other_node->count; ++new_node->count) {
+        new (new_node->data() + new_node->count)
+            T(other_node->data()[new_node->count]);
+      }
+      size_ += new_node->count;
+    }
+  }
+
+  void clear_list() {
+    while (fakeNode.next != &fakeNode) {
+      destroy_node(as_node(fakeNode.next));
+    }
+    size_ = 0;
+  }
+
+ public:
+  UnrolledList() : fakeNode() {}
+
+  UnrolledList(Alloc allocator) : node_alloc_(allocator), fakeNode() {}
+
+  UnrolledList(size_t count, const T& value, Alloc allocator = Alloc())
+      : node_alloc_(allocator), fakeNode() {
+    try {
+      for (size_t i = 0; i < count; ++i) {
+        push_back(value);
+      }
+    } catch (...) {
+      clear_list();
+      throw;
+    }
+  }
+
+  UnrolledList(const UnrolledList& other)
+      : node_alloc_(std::allocator_traits<NodeAlloc>::
+                        select_on_container_copy_construction(
+                            other.node_alloc_)),
+        fakeNode() {
+    try {
+      copy_from(other);
+    } catch (...) {
+      clear_list();
+      throw;
+    }
+  }
+
+  UnrolledList& operator=(const UnrolledList& other) {
+    if (&other == this) {
+      return *this;
+    }
+    clear_list();
+    if (std::allocator_traits<
+            NodeAlloc>::propagate_on_container_copy_assignment::value) {
+      node_alloc_ = other.node_alloc_;
+    }
+    try {
+      copy_from(other);
+    } catch (...) {
+      clear_list();
+      throw;
+    }
+    return *this;
+  }
+
+  ~UnrolledList() { clear_list(); }
+
+  size_t size() const { return size_; }
+
+  NodeAlloc get_allocator() const { return node_alloc_; }
+
+  void push_back(const T& value) {
+    if (fakeNode.prev == &fakeNode || as_node(fakeNode.prev)->count == K) {
+      Node* new_node = create_node(&fakeNode);
+      try {
+        insert_into(new_node, 0, value);
+      } catch (...) {
+        destroy_node(new_node);
+        throw;
+      }
+    } else {
+      Node* node = as_node(fakeNode.prev);
+      insert_into(node, node->count, value);
+    }
+  }
+
+  void push_front(const T& value) {
+    if (fakeNode.next == &fakeNode || as_node(fakeNode.next)->count == K) {
+      Node* new_node = create_node(fakeNode.next);
+      try {
+        insert_into(new_node, 0, value);
+      } catch (...) {
+        destroy_node(new_node);
+        throw;
+      }
+    } else {
+      insert_into(as_node(fakeNode.next), 0, value);
+    }
+  }
+
+  void pop_back() {
+    Node* node = as_node(fakeNode.prev);
+    node->data()[--node->count].~T();
+    --size_;
+    if (node->count == 0) {
+      destroy_node(node);
+    }
+  }
+
+  void pop_front() { erase(begin()); }
+
+  template <bool is_const>
+  struct Unrolled_Iterator {
+    BaseNode* node;
+    T* cur;
+    T* last;
+    BaseNode* fake;
+
+    Unrolled_Iterator()
+        : node(nullptr), cur(nullptr), last(nullptr), fake(nullptr) {}
+
+    Unrolled_Iterator(const BaseNode* node1, size_t index,
+                      const BaseNode* fake1)
+        : node(const_cast<BaseNode*>(node1)),
+          cur(nullptr),
+          last(nullptr),
+          fake(const_cast<BaseNode*>(fake1)) {
+      if (node != fake) {
+        cur = static_cast<Node*>(node)->data() + index;
+        last = static_cast<Node*>(node)->data() + static_cast<Node*>(node)->count;
+      }
+    }
+
+    size_t index() const {
+      return node == fake ? 0 : cur - static_cast<Node*>(node)->data();
+    }
+
+    Unrolled_Iterator& operator++() {
+      if (++cur == last) {
+        *this = Unrolled_Iterator(node->next, 0, fake);
+      }
+      return *this;
+    }
+
+    Unrolled_Iterator operator++(int) {
+      Unrolled_Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    Unrolled_Iterator& operator--() {
+      if (node == fake || cur == static_cast<Node*>(node)->data()) {
+        BaseNode* prev_node = node->prev;
+        *this = Unrolled_Iterator(prev_node, static_cast<Node*>(prev_node)->count,
+                                  fake);
+      }
+      --cur;
+      return *this;
+    }
+
+    Unrolled_Iterator operator--(int) {
+      Unrolled_Iterator copy = *this;
+      --*this;
+      return copy;
+    }
+
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<is_const, const T*, T*>;
+    using reference = std::conditional_t<is_const, const T&, T&>;
+
+    reference operator*() const { return *cur; }
+
+    pointer operator->() const { return cur; }
+
+    operator Unrolled_Iterator<true>() const {
+      return Unrolled_Iterator<true>(node, index(), fake);
+    }
+
+    bool operator==(const Unrolled_Iterator& another) const {
+      return node == another.node && cur == another.cur;
+    }
+
+    bool operator!=(const Unrolled_Iterator& another) const {
+      return !(*this == another);
+    }
+  };
+
+  using iterator = Unrolled_Iterator<false>;
+  using const_iterator = Unrolled_Iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  iterator begin() { return {fakeNode.next, 0, &fakeNode}; }
+
+  const_iterator begin() const { return {fakeNode.next, 0, &fakeNode}; }
+
+  const_iterator cbegin() const { return {fakeNode.next, 0, &fakeNode}; }
+
+  iterator end() { return {&fakeNode, 0, &fakeNode}; }
+
+  const_iterator end() const { return {&fakeNode, 0, &fakeNode}; }
+
+  const_iterator cend() const { return {&fakeNode, 0, &fakeNode}; }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  template <bool is_const>
+  iterator insert(Unrolled_Iterator<is_const> it, const T& value) {
+    if (it.node == &fakeNode) {
+      push_back(value);
+      return --end();
+    }
+    Node* node = as_node(it.node);
+    size_t index = it.index();
+    if (node->count == K) {
+      Node* new_node = split(node);
+      if (index > node->count) {
+        index -= node->count;
+        node = new_node;
+      }
+    }
+    insert_into(node, index, value);
+    return {node, index, &fakeNode};
+  }
+
+  template <bool is_const>
+  iterator erase(Unrolled_Iterator<is_const> it) {
+    Node* node = as_node(it.node);
+    size_t index = it.index();
+    T* data = node->data();
+    for (size_t i = index; i + 1 < node->count; ++i) {
+      data[i] = std::move(data[i + 1]);
+    }
+    data[--node->count].~T();
+    --size_;
+    if (node->count == 0) {
+      BaseNode* next_node = node->next;
+      destroy_node(node);
+      return {next_node, 0, &fakeNode};
+    }
+    if (node->count < K / 2) {
+      merge_with_next(node);
+    }
+    if (index == node->count) {
+      return {node->next, 0, &fakeNode};
+    }
+    return {node, index, &fakeNode};
+  }
+};
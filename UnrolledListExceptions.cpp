@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+#include "UnrolledList.cpp"
+
+struct Tracked {
+  static inline std::set<const Tracked*> alive;
+  static inline size_t moves_until_throw = 0;
+  static inline bool errors = false;
+
+  int value;
+
+  static void before_move() {
+    if (moves_until_throw != 0 && --moves_until_throw == 0) {
+      throw std::runtime_error("move failed");
+    }
+  }
+
+  Tracked(int value) : value(value) { alive.insert(this); }
+
+  Tracked(const Tracked& other) : value(other.value) { alive.insert(this); }
+
+  Tracked(Tracked&& other) : value(other.value) {
+    before_move();
+    alive.insert(this);
+  }
+
+  Tracked& operator=(const Tracked& other) {
+    value = other.value;
+    return *this;
+  }
+
+  Tracked& operator=(Tracked&& other) {
+    before_move();
+    value = other.value;
+    return *this;
+  }
+
+  ~Tracked() {
+    if (alive.erase(this) == 0) {
+      std::cerr << "double destroy\n";
+      errors = true;
+    }
+  }
+};
+
+template <typename Operation>
+bool check_every_throw_point(const char* name, Operation operation) {
+  bool ok = true;
+  for (size_t throw_at = 1;; ++throw_at) {
+    bool thrown = false;
+    {
+      UnrolledList<Tracked, 8> list;
+      for (int i = 0; i < 8; ++i) {
+        list.push_back(Tracked(i));
+      }
+      Tracked::moves_until_throw = throw_at;
+      try {
+        operation(list);
+      } catch (const std::runtime_error&) {
+        thrown = true;
+      }
+      Tracked::moves_until_throw = 0;
+      size_t walked = 0;
+      for (auto it = list.begin(); it != list.end(); ++it) {
+        ++walked;
+      }
+      if (walked != list.size()) {
+        std::cerr << name << ": size " << list.size() << " but walked "
+                  << walked << '\n';
+        ok = false;
+      }
+    }
+    if (!Tracked::alive.empty()) {
+      std::cerr << name << ": leaked " << Tracked::alive.size() << '\n';
+      Tracked::alive.clear();
+      ok = false;
+    }
+    if (!thrown) {
+      return ok;
+    }
+  }
+}
+
+int main() {
+  bool ok = true;
+  ok = check_every_throw_point("insert into full node", [](auto& list) {
+         list.insert(++list.begin(), Tracked(100));
+       }) && ok;
+  ok = check_every_throw_point("insert into partial node", [](auto& list) {
+         list.pop_back();
+         list.insert(++list.begin(), Tracked(100));
+       }) && ok;
+  ok = check_every_throw_point("erase with merge", [](auto& list) {
+         list.insert(list.begin(), Tracked(100));
+         for (int i = 0; i < 3; ++i) {
+           list.erase(list.begin());
+         }
+       }) && ok;
+  ok = ok && !Tracked::errors;
+  std::cout << (ok ? "ok" : "FAILED") << '\n';
+  return ok ? 0 : 1;
+}
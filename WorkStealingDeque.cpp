@@ -0,0 +1,209 @@
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+template <typename T, size_t BlockSize = 256, typename Alloc = std::allocator<T>>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(std::atomic<T>::is_always_lock_free);
+  static_assert(std::has_single_bit(BlockSize));
+
+ private:
+  struct Block {
+    std::atomic<T> cells[BlockSize];
+  };
+
+  struct Map {
+    size_t mask;
+    Block** blocks;
+    Map* retired_next;
+  };
+
+  using BlockAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+  using BlockPtrAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Block*>;
+  using MapAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<Map>;
+
+  static constexpr size_t block_shift = std::countr_zero(BlockSize);
+
+  BlockAlloc block_alloc_;
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  alignas(64) std::atomic<Map*> map_;
+  Map* retired_;
+
+  Block* allocate_block() {
+    Block* block = std::allocator_traits<BlockAlloc>::allocate(block_alloc_, 1);
+    std::allocator_traits<BlockAlloc>::construct(block_alloc_, block);
+    return block;
+  }
+
+  void deallocate_block(Block* block) {
+    std::allocator_traits<BlockAlloc>::destroy(block_alloc_, block);
+    std::allocator_traits<BlockAlloc>::deallocate(block_alloc_, block, 1);
+  }
+
+  Map* allocate_map(size_t blocks_count) {
+    MapAlloc map_alloc(block_alloc_);
+    BlockPtrAlloc pointers_alloc(block_alloc_);
+    Map* map = std::allocator_traits<MapAlloc>::allocate(map_alloc, 1);
+    try {
+      map->blocks = std::allocator_traits<BlockPtrAlloc>::allocate(
+          pointers_alloc, blocks_count);
+    } catch (...) {
+      std::allocator_traits<MapAlloc>::deallocate(map_alloc, map, 1);
+      throw;
+    }
+    map->mask = blocks_count - 1;
+    map->retired_next = nullptr;
+    return map;
+  }
+
+  void deallocate_map(Map* map) {
+    MapAlloc map_alloc(block_alloc_);
+    BlockPtrAlloc pointers_alloc(block_alloc_);
+    std::allocator_traits<BlockPtrAlloc>::deallocate(pointers_alloc,
+                                                     map->blocks, map->mask + 1);
+    std::allocator_traits<MapAlloc>::deallocate(map_alloc, map, 1);
+  }
+
+  static std::atomic<T>& cell(Map* map, int64_t index) {
+    return map->blocks[(index >> block_shift) & map->mask]
+        ->cells[index & (BlockSize - 1)];
+  }
+
+  Map* grow(Map* old_map, int64_t top) {
+    size_t old_count = old_map->mask + 1;
+    Map* new_map = allocate_map(2 * old_count);
+    int64_t first_block = top >> block_shift;
+    size_t allocated = 0;
+    try {
+      for (; allocated < old_count; ++allocated) {
+        new_map->blocks[(first_block + old_count + allocated) & new_map->mask] =
+            allocate_block();
+      }
+    } catch (...) {
+      for (size_t k = 0; k < allocated; ++k) {
+        deallocate_block(
+            new_map->blocks[(first_block + old_count + k) & new_map->mask]);
+      }
+      deallocate_map(new_map);
+      throw;
+    }
+    for (size_t k = 0; k < old_count; ++k) {
+      new_map->blocks[(first_block + k) & new_map->mask] =
+          old_map->blocks[(first_block + k) & old_map->mask];
+    }
+    old_map->retired_next = retired_;
+    retired_ = old_map;
+    map_.store(new_map, std::memory_order_release);
+    return new_map;
+  }
+
+ public:
+  WorkStealingDeque(size_t initial_blocks = 2, Alloc allocator = Alloc())
+      : block_alloc_(allocator), top_(0), bottom_(0), retired_(nullptr) {
+    size_t blocks_count = std::bit_ceil(initial_blocks < 2 ? 2 : initial_blocks);
+    Map* map = allocate_map(blocks_count);
+    size_t allocated = 0;
+    try {
+      for (; allocated < blocks_count; ++allocated) {
+        map->blocks[allocated] = allocate_block();
+      }
+    } catch (...) {
+      for (size_t k = 0; k < allocated; ++k) {
+        deallocate_block(map->blocks[k]);
+      }
+      deallocate_map(map);
+      throw;
+    }
+    map_.store(map, std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque& src) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque& src) = delete;
+
+  ~WorkStealingDeque() {
+    Map* map = map_.load(std::memory_order_relaxed);
+    for (size_t k = 0; k <= map->mask; ++k) {
+      deallocate_block(map->blocks[k]);
+    }
+    deallocate_map(map);
+    while (retired_ != nullptr) {
+      Map* next_map = retired_->retired_next;
+      deallocate_map(retired_);
+      retired_ = next_map;
+    }
+  }
+
+  void push(T value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    Map* map = map_.load(std::memory_order_relaxed);
+    if ((bottom >> block_shift) - (top >> block_shift) >
+        static_cast<int64_t>(map->mask)) {
+      map = grow(map, top);
+    }
+    cell(map, bottom).store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  bool try_pop(T& value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Map* map = map_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    T popped = cell(map, bottom).load(std::memory_order_relaxed);
+    if (top == bottom) {
+      bool won = top_.compare_exchange_strong(top, top + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      if (!won) {
+        return false;
+      }
+    }
+    value = popped;
+    return true;
+  }
+
+  bool try_steal(T& value) {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    Map* map = map_.load(std::memory_order_acquire);
+    T stolen = cell(map, top).load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    value = stolen;
+    return true;
+  }
+
+  size_t size() const {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  size_t capacity() const {
+    return (map_.load(std::memory_order_relaxed)->mask + 1) * BlockSize;
+  }
+};
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "WorkStealingDeque.cpp"
+
+struct StressResult {
+  bool consumed_once;
+  double seconds;
+};
+
+StressResult run_stress(size_t tasks_count, size_t thieves_count) {
+  WorkStealingDeque<uint32_t, 64> deque;
+  std::vector<std::atomic<uint32_t>> consumed(tasks_count);
+  std::atomic<bool> pushing_done(false);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> thieves;
+  thieves.reserve(thieves_count);
+  for (size_t i = 0; i < thieves_count; ++i) {
+    thieves.emplace_back([&] {
+      uint32_t task;
+      while (true) {
+        if (deque.try_steal(task)) {
+          consumed[task].fetch_add(1, std::memory_order_relaxed);
+        } else if (pushing_done.load(std::memory_order_acquire) &&
+                   deque.empty()) {
+          return;
+        }
+      }
+    });
+  }
+
+  uint32_t task;
+  for (size_t i = 0; i < tasks_count; ++i) {
+    deque.push(static_cast<uint32_t>(i));
+    if (i % 3 == 2 && deque.try_pop(task)) {
+      consumed[task].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  while (deque.try_pop(task)) {
+    consumed[task].fetch_add(1, std::memory_order_relaxed);
+  }
+  pushing_done.store(true, std::memory_order_release);
+  for (std::thread& thief : thieves) {
+    thief.join();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  bool consumed_once = true;
+  for (size_t i = 0; i < tasks_count; ++i) {
+    if (consumed[i].load(std::memory_order_relaxed) != 1) {
+      std::cerr << "task " << i << " consumed "
+                << consumed[i].load(std::memory_order_relaxed) << " times\n";
+      consumed_once = false;
+      break;
+    }
+  }
+  return {consumed_once, elapsed.count()};
+}
+
+int main(int argc, char** argv) {
+  size_t tasks_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 21;
+  size_t max_thieves =
+      argc > 2 ? std::strtoull(argv[2], nullptr, 10)
+               : std::max<size_t>(1, std::thread::hardware_concurrency());
+  bool ok = true;
+  for (size_t thieves = 1; thieves <= max_thieves; ++thieves) {
+    StressResult result = run_stress(tasks_count, thieves);
+    std::cout << thieves << " thieves: " << tasks_count << " tasks in "
+              << result.seconds << " s, "
+              << tasks_count / result.seconds / 1e6 << " M tasks/s"
+              << (result.consumed_once ? "" : " FAILED") << '\n';
+    ok = ok && result.consumed_once;
+  }
+  return ok ? 0 : 1;
+}